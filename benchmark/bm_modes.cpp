@@ -0,0 +1,123 @@
+/*
+* MIT License
+* 
+* Copyright (c) 2021 juliokscesar
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+/*
+Compares the static library and header only (GRIFFIN_LOG_HEADER_ONLY) builds.
+Compile With:
+g++ -std=c++20 -O3 -o bm_modes_static bm_modes.cpp ../src/griffinLog/griffinLog.cpp ../src/griffinLog/shm_ring.cpp
+g++ -std=c++20 -O3 -DGRIFFIN_LOG_HEADER_ONLY -o bm_modes_header_only bm_modes.cpp
+*/
+
+#include <stdio.h>
+
+#if defined(WIN32) || defined(_WIN32)
+
+#include <Windows.h>
+
+#else
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#endif // WIN32 || _WIN32
+
+#include "../src/griffinLog/griffinLog.hpp"
+
+
+double get_time()
+{
+    #ifdef _WIN32
+
+    LARGE_INTEGER t, f;
+    QueryPerformanceCounter(&t);
+    QueryPerformanceFrequency(&f);
+    return (double)t.QuadPart/(double)f.QuadPart;
+
+    #else
+
+    struct timeval t;
+    struct timezone tzp;
+    gettimeofday(&t, &tzp);
+    return t.tv_sec + t.tv_usec*1e-6;
+
+    #endif // _WIN32
+}
+
+int main()
+{
+    #if defined(GRIFFIN_LOG_HEADER_ONLY)
+    const char* mode = "header only";
+    #else
+    const char* mode = "static library";
+    #endif // GRIFFIN_LOG_HEADER_ONLY
+
+    // Console output is not what is being measured here
+    #if defined(_WIN32)
+    freopen("NUL", "w", stderr);
+    #else
+    freopen("/dev/null", "w", stderr);
+    #endif // _WIN32
+
+    const int filtered_count = 10000000;
+    const int logged_count = 200000;
+
+    grflog::set_console_flush(false);
+    grflog::set_log_level(grflog::log_level::WARN);
+
+    double filtered_start = get_time();
+
+    for (int i = 0; i < filtered_count; i++)
+        grflog::info("Filtered out");
+
+    double filtered_end = get_time();
+
+    // Longer than the small string buffer, so building a std::string from it would allocate
+    double filtered_long_start = get_time();
+
+    for (int i = 0; i < filtered_count; i++)
+        grflog::info("Filtered out message that is longer than the small string buffer {}", i);
+
+    double filtered_long_end = get_time();
+
+    double logged_start = get_time();
+
+    for (int i = 0; i < logged_count; i++)
+        grflog::warn("Logged message");
+
+    double logged_end = get_time();
+
+    double formatted_start = get_time();
+
+    for (int i = 0; i < logged_count; i++)
+        grflog::warn("Logged message {}", i);
+
+    double formatted_end = get_time();
+
+    printf("Mode: %s\n", mode);
+    printf("Filtered calls:  %f ns/call\n", (filtered_end - filtered_start) * 1e9 / filtered_count);
+    printf("Filtered long:   %f ns/call\n", (filtered_long_end - filtered_long_start) * 1e9 / filtered_count);
+    printf("Logged calls:    %f ns/call\n", (logged_end - logged_start) * 1e9 / logged_count);
+    printf("Formatted calls: %f ns/call\n", (formatted_end - formatted_start) * 1e9 / logged_count);
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+* MIT License
+* 
+* Copyright (c) 2021 juliokscesar
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+/*
+Control character scan on clean and dirty messages, vectorized against scalar.
+Compile With:
+g++ -std=c++20 -O3 -DGRIFFIN_LOG_HEADER_ONLY -o bm_sanitize bm_sanitize.cpp
+(add -mavx2 for the AVX2 path, SSE2 is the x86-64 baseline)
+*/
+
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../src/griffinLog/griffinLog.hpp"
+
+template<typename F>
+double ns_per_message(const std::vector<std::string>& messages, int rounds, F&& f)
+{
+    std::size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int r = 0; r < rounds; r++)
+        for (const std::string& m : messages)
+            sink += f(m);
+
+    auto end = std::chrono::steady_clock::now();
+
+    if (sink == 1)
+        printf("unlikely\n");
+    return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(rounds) * messages.size());
+}
+
+int main()
+{
+    const int rounds = 20000;
+
+    std::vector<std::string> clean, dirty;
+    for (int i = 0; i < 100; i++)
+    {
+        std::string m = "request " + std::to_string(i) + " handled for user some.user@example.com in tenant acme, status 200 OK";
+        clean.push_back(m);
+        m[m.size() / 2] = '\n';
+        dirty.push_back(m);
+    }
+
+    auto scan = [](const std::string& m) { return grflog::sanitize::find_control(m.data(), m.size()); };
+    auto scan_scalar = [](const std::string& m) { return grflog::sanitize::find_control_scalar(m.data(), m.size()); };
+    auto sanitize = [](const std::string& m) { std::string c = m; grflog::sanitize::sanitize_content(c); return c.size(); };
+
+    printf("Clean scan, vectorized: %f ns/message\n", ns_per_message(clean, rounds, scan));
+    printf("Clean scan, scalar:     %f ns/message\n", ns_per_message(clean, rounds, scan_scalar));
+    printf("Clean sanitize (copy):  %f ns/message\n", ns_per_message(clean, rounds, sanitize));
+    printf("Dirty sanitize (copy):  %f ns/message\n", ns_per_message(dirty, rounds, sanitize));
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*
+* MIT License
+* 
+* Copyright (c) 2021 juliokscesar
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+/*
+Scoped timer overhead when the threshold isn't crossed.
+Compile With:
+g++ -std=c++20 -O3 -DGRIFFIN_LOG_HEADER_ONLY -o bm_timer bm_timer.cpp
+(add -DGRIFFIN_LOG_TIMER_TSC to read the TSC instead of steady_clock)
+*/
+
+#include <stdio.h>
+#include <chrono>
+
+#include "../src/griffinLog/griffinLog.hpp"
+#include "../src/griffinLog/scoped_timer.hpp"
+
+int main()
+{
+    const int count = 10000000;
+    grflog::latency_histogram& h = grflog::get_histogram("bm_timer");
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < count; i++)
+    {
+        grflog::scoped_timer t("bm_timer", std::chrono::seconds(1));
+    }
+
+    auto mid = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < count; i++)
+    {
+        grflog::scoped_timer t("bm_timer", h);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    printf("Timer under threshold:   %f ns/scope\n", std::chrono::duration<double, std::nano>(mid - start).count() / count);
+    printf("Timer into histogram:    %f ns/scope\n", std::chrono::duration<double, std::nano>(end - mid).count() / count);
+    printf("Histogram p50 %llu ns, p99 %llu ns\n",
+        static_cast<unsigned long long>(h.percentile(50.0)),
+        static_cast<unsigned long long>(h.percentile(99.0)));
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 juliokscesar
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+/*
+Standalone collector for the shared memory ring.
+Usage: grflog_collector <ring name> [log file name]
+Producers attach with grflog::shm::attach_producer("<ring name>"). Stops on SIGINT or SIGTERM.
+*/
+
+#include <csignal>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+
+#include "griffinLog/griffinLog.hpp"
+#include "griffinLog/shm_ring.hpp"
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void on_signal(int)
+{
+    g_stop = 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <ring name> [log file name]\n", argv[0]);
+        return 1;
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    if (argc > 2)
+        grflog::set_file_logger(grflog::file_logger(argv[2]));
+
+    grflog::shm::collector c(argv[1]);
+    if (!c.open())
+    {
+        std::fprintf(stderr, "couldn't create shared memory ring '%s'\n", argv[1]);
+        return 1;
+    }
+
+    while (!g_stop)
+    {
+        if (c.drain() == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    c.stop();
+
+    const grflog::shm::ring& r = c.get_ring();
+    if (r.dropped_count() > 0 || r.recovered_count() > 0)
+        std::fprintf(stderr, "dropped %llu events, recovered %llu slots from crashed producers\n",
+            static_cast<unsigned long long>(r.dropped_count()),
+            static_cast<unsigned long long>(r.recovered_count()));
+
+    grflog::stop_file_logging();
+    return 0;
+}
@@ -0,0 +1,780 @@
+/* 
+* MIT License
+* 
+* Copyright (c) 2021 juliokscesar
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#if !defined(GRIFFIN_LOG_HEADER_ONLY)
+    #include "griffinLog.hpp"
+#endif // GRIFFIN_LOG_HEADER_ONLY
+
+#include <cstdint>
+#include <ctime>
+#include <cstdio>
+#include <array>
+#include <bit>
+#include <utility>
+
+#if defined(GRIFFIN_LOG_LINUX)
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <unistd.h>
+#endif // GRIFFIN_LOG_LINUX
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif // __AVX2__
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define GRIFFIN_LOG_SSE2
+#endif // __SSE2__ || _M_X64
+
+namespace grflog
+{
+    #if defined(GRIFFIN_LOG_LINUX)
+    namespace shm
+    {
+        // Defined in shm_ring-inl.hpp, included at the end of this file
+        GRIFFIN_LOG_INLINE bool forward(const log_event& l_ev);
+    }
+    #endif // GRIFFIN_LOG_LINUX
+
+    namespace sys_methods
+    {
+        GRIFFIN_LOG_INLINE void make_directory(const std::string& dir_path)
+        {
+            #if defined(GRIFFIN_LOG_WIN32)
+
+            CreateDirectoryA(dir_path.c_str(), nullptr);
+
+            #elif defined(GRIFFIN_LOG_LINUX)
+
+            mkdir(dir_path.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+
+            #endif // GRIFFIN_LOG_WIN32
+        }
+
+        GRIFFIN_LOG_INLINE GRIFFIN_FILE_HANDLE open_sync_handle(const std::string& path)
+        {
+            #if defined(GRIFFIN_LOG_WIN32)
+
+            return CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+            #elif defined(GRIFFIN_LOG_LINUX)
+
+            return open(path.c_str(), O_WRONLY | O_CLOEXEC);
+
+            #endif // GRIFFIN_LOG_WIN32
+        }
+
+        GRIFFIN_LOG_INLINE bool sync_file_data(GRIFFIN_FILE_HANDLE handle)
+        {
+            if (handle == GRIFFIN_INVALID_FILE_HANDLE)
+                return false;
+
+            #if defined(GRIFFIN_LOG_WIN32)
+
+            return FlushFileBuffers(handle) != 0;
+
+            #elif defined(GRIFFIN_LOG_LINUX)
+
+            return fdatasync(handle) == 0;
+
+            #endif // GRIFFIN_LOG_WIN32
+        }
+
+        GRIFFIN_LOG_INLINE bool sync_directory(const std::string& dir_path)
+        {
+            #if defined(GRIFFIN_LOG_WIN32)
+
+            // NTFS journals the new directory entry, and syncing a directory handle needs backup privileges
+            (void)dir_path;
+            return true;
+
+            #elif defined(GRIFFIN_LOG_LINUX)
+
+            const int fd = open(dir_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+                return false;
+
+            const bool synced = fsync(fd) == 0;
+            close(fd);
+            return synced;
+
+            #endif // GRIFFIN_LOG_WIN32
+        }
+
+
+        GRIFFIN_LOG_INLINE void close_sync_handle(GRIFFIN_FILE_HANDLE handle)
+        {
+            if (handle == GRIFFIN_INVALID_FILE_HANDLE)
+                return;
+
+            #if defined(GRIFFIN_LOG_WIN32)
+
+            CloseHandle(handle);
+
+            #elif defined(GRIFFIN_LOG_LINUX)
+
+            close(handle);
+
+            #endif // GRIFFIN_LOG_WIN32
+        }
+
+        GRIFFIN_LOG_INLINE const std::string get_date_time()
+        {
+            char datetime[21];
+
+            #if defined(GRIFFIN_LOG_WIN32) && defined(_MSC_VER)
+            
+            SYSTEMTIME lt;
+            GetLocalTime(&lt);
+
+            snprintf(datetime, 20, "%02d-%02d-%02d %02d:%02d:%02d",
+                lt.wYear,
+                lt.wMonth,
+                lt.wDay,
+                lt.wHour,
+                lt.wMinute,
+                lt.wSecond
+            );
+
+            #else
+
+            std::time_t t = std::time(nullptr);
+            std::tm now;
+            #if defined(GRIFFIN_LOG_LINUX)
+            localtime_r(&t, &now);
+            #else
+            now = *(localtime(&t));
+            #endif // GRIFFIN_LOG_LINUX
+            strftime(datetime, 20, "%Y-%m-%d %H:%M:%S", &now);
+
+            #endif // GRIFFIN_LOG_WIN32 && _MSC_VER
+
+
+            return std::string(std::move(datetime));
+        }
+
+	
+    }
+
+
+    namespace visual
+    {
+        GRIFFIN_LOG_INLINE const std::string get_log_lvl_str(const log_level& lvl)
+        {
+            static const std::array<const std::string, 5> log_level_strs = { "INFO", "DEBUG", "WARN", "CRITICAL", "FATAL" };
+	    
+            return log_level_strs[static_cast<uint32_t>(lvl)];
+        }
+
+        GRIFFIN_LOG_INLINE const GRIFFIN_COLOR get_log_lvl_color(const log_level& lvl)
+        {
+            static const std::array<const GRIFFIN_COLOR, 5> log_level_colors = { GRIFFIN_COLOR_BLUE, GRIFFIN_COLOR_GREEN, GRIFFIN_COLOR_YELLOW, GRIFFIN_COLOR_RED, GRIFFIN_COLOR_BLACK_RED };
+            return log_level_colors[static_cast<uint32_t>(lvl)];
+        }
+
+        #ifdef GRIFFIN_LOG_WIN32
+        /// Function to get the default text attributes in Windows. Really bad, but will stay like that for now.
+        /// @returns WORD default console's attributes.
+        GRIFFIN_LOG_INLINE WORD get_win32_default_attributes()
+        {
+            static bool already_got = false;
+            static WORD attrb;
+
+            if (!already_got)
+            {
+                CONSOLE_SCREEN_BUFFER_INFO Info;
+                HANDLE hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
+                GetConsoleScreenBufferInfo(hStdout, &Info);
+                attrb = Info.wAttributes;
+                already_got = true;
+            }
+            
+            return attrb;
+        }
+        #endif // GRIFFIN_LOG_WIN32
+
+        GRIFFIN_LOG_INLINE void set_text_color(const log_level& lvl)
+        {
+            const GRIFFIN_COLOR color = get_log_lvl_color(lvl);
+
+            #if defined(GRIFFIN_LOG_WIN32)
+            
+            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+
+            #elif defined(GRIFFIN_LOG_LINUX)
+
+            std::fputs(color.c_str(), stderr);
+
+            #endif
+        }
+
+        GRIFFIN_LOG_INLINE void reset_text_color()
+        {
+             #if defined(GRIFFIN_LOG_WIN32)
+
+            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), get_win32_default_attributes());
+
+            #elif defined(GRIFFIN_LOG_LINUX)
+
+            std::fputs(GRIFFIN_COLOR_RESET, stderr);
+
+            #endif
+        }
+
+        GRIFFIN_LOG_INLINE const std::string get_sample_rate_str(double rate)
+        {
+            if (rate >= 1.0)
+                return std::string();
+
+            char tag[40];
+            snprintf(tag, sizeof(tag), "[sample rate %g] ", rate);
+            return std::string(tag);
+        }
+    }
+
+    /// Get the flag telling console_log() to flush at every log.
+    GRIFFIN_LOG_INLINE bool& get_console_flush_enabled()
+    {
+        static bool flush_console_enabled = true;
+        return flush_console_enabled;
+    }
+
+    GRIFFIN_LOG_INLINE void console_log(const log_event& l_ev)
+    {
+        visual::reset_text_color();
+
+        std::fprintf(stderr, "[%s] [", l_ev.date_time.c_str());
+
+        visual::set_text_color(l_ev.lvl);
+        std::fputs(l_ev.log_lvl_str.c_str(), stderr);
+        visual::reset_text_color();
+
+        std::fprintf(stderr, "] %s%s\n", visual::get_sample_rate_str(l_ev.sample_rate).c_str(), l_ev.content.c_str());
+
+        if (get_console_flush_enabled())
+            std::fflush(stderr);
+    }
+
+    GRIFFIN_LOG_INLINE void set_console_flush(bool flush_console) {
+        get_console_flush_enabled() = flush_console;
+    }
+
+    namespace sanitize
+    {
+        /// Check if c is a control character or backslash to escape, tab is left alone.
+        GRIFFIN_LOG_INLINE bool is_control(char c)
+        {
+            const uint8_t b = static_cast<uint8_t>(c);
+            return (b < 0x20 && b != '\t') || b == 0x7f || b == '\\';
+        }
+
+        GRIFFIN_LOG_INLINE std::size_t find_control_scalar(const char* data, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; i++)
+            {
+                if (is_control(data[i]))
+                    return i;
+            }
+            return size;
+        }
+
+        GRIFFIN_LOG_INLINE std::size_t find_control(const char* data, std::size_t size)
+        {
+            std::size_t i = 0;
+
+            // A byte b is below 0x20 (unsigned) when min(b, 0x1f) == b
+
+            #if defined(__AVX2__)
+
+            const __m256i limit32 = _mm256_set1_epi8(0x1f);
+            const __m256i tab32 = _mm256_set1_epi8('\t');
+            const __m256i del32 = _mm256_set1_epi8(0x7f);
+            const __m256i backslash32 = _mm256_set1_epi8('\\');
+
+            for (; i + 32 <= size; i += 32)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, limit32), v);
+                ctrl = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, tab32), ctrl);
+                ctrl = _mm256_or_si256(ctrl, _mm256_cmpeq_epi8(v, del32));
+                ctrl = _mm256_or_si256(ctrl, _mm256_cmpeq_epi8(v, backslash32));
+
+                const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(ctrl));
+                if (mask != 0)
+                    return i + static_cast<std::size_t>(std::countr_zero(mask));
+            }
+
+            #endif // __AVX2__
+
+            #if defined(GRIFFIN_LOG_SSE2)
+
+            const __m128i limit16 = _mm_set1_epi8(0x1f);
+            const __m128i tab16 = _mm_set1_epi8('\t');
+            const __m128i del16 = _mm_set1_epi8(0x7f);
+            const __m128i backslash16 = _mm_set1_epi8('\\');
+
+            for (; i + 16 <= size; i += 16)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(v, limit16), v);
+                ctrl = _mm_andnot_si128(_mm_cmpeq_epi8(v, tab16), ctrl);
+                ctrl = _mm_or_si128(ctrl, _mm_cmpeq_epi8(v, del16));
+                ctrl = _mm_or_si128(ctrl, _mm_cmpeq_epi8(v, backslash16));
+
+                const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+                if (mask != 0)
+                    return i + static_cast<std::size_t>(std::countr_zero(mask));
+            }
+
+            #endif // GRIFFIN_LOG_SSE2
+
+            return i + find_control_scalar(data + i, size - i);
+        }
+
+        GRIFFIN_LOG_INLINE void escape_controls(std::string& content, std::size_t from)
+        {
+            static const char hex[] = "0123456789abcdef";
+
+            std::string escaped;
+            escaped.reserve(content.size() + 8);
+            escaped.append(content, 0, from);
+
+            for (std::size_t i = from; i < content.size(); i++)
+            {
+                const char c = content[i];
+                if (!is_control(c))
+                {
+                    escaped.push_back(c);
+                    continue;
+                }
+
+                escaped.push_back('\\');
+                if (c == '\\')
+                    escaped.push_back('\\');
+                else if (c == '\n')
+                    escaped.push_back('n');
+                else if (c == '\r')
+                    escaped.push_back('r');
+                else
+                {
+                    const uint8_t b = static_cast<uint8_t>(c);
+                    escaped.push_back('x');
+                    escaped.push_back(hex[b >> 4]);
+                    escaped.push_back(hex[b & 0xf]);
+                }
+            }
+
+            content.swap(escaped);
+        }
+    }
+
+    /// Append a context value, quoted and escaped if it could be read as field syntax or forge a line.
+    GRIFFIN_LOG_INLINE void append_context_value(std::string& out, const std::string& value)
+    {
+        const bool plain = !value.empty()
+            && value.find_first_of(" ={}\"") == std::string::npos
+            && sanitize::find_control(value.data(), value.size()) == value.size();
+        if (plain)
+        {
+            out.append(value);
+            return;
+        }
+
+        std::string escaped = value;
+        sanitize::escape_controls(escaped);
+
+        out.push_back('"');
+        for (const char c : escaped)
+        {
+            if (c == '"')
+                out.push_back('\\');
+            out.push_back(c);
+        }
+        out.push_back('"');
+    }
+
+    /* class context_guard */
+    GRIFFIN_LOG_INLINE context_guard::context_guard(std::initializer_list<context_field> fields)
+    {
+        log_context& ctx = t_log_context;
+        m_previous_size = ctx.fields.size();
+
+        for (const context_field& field : fields)
+        {
+            if (!ctx.fields.empty())
+                ctx.fields.push_back(' ');
+            ctx.fields.append(field.key).append("=");
+            append_context_value(ctx.fields, field.value);
+        }
+
+        ctx.render();
+    }
+
+    GRIFFIN_LOG_INLINE context_guard::~context_guard()
+    {
+        log_context& ctx = t_log_context;
+        ctx.fields.resize(m_previous_size);
+        ctx.render();
+    }
+
+    GRIFFIN_LOG_INLINE context_snapshot capture_context()
+    {
+        return context_snapshot{ t_log_context.fields };
+    }
+
+    /* class context_restore */
+    GRIFFIN_LOG_INLINE context_restore::context_restore(const context_snapshot& snapshot)
+        : m_previous_fields(t_log_context.fields)
+    {
+        t_log_context.fields = snapshot.fields;
+        t_log_context.render();
+    }
+
+    GRIFFIN_LOG_INLINE context_restore::~context_restore()
+    {
+        t_log_context.fields.swap(m_previous_fields);
+        t_log_context.render();
+    }
+
+    // File logging function and class implementations
+
+    /* class file_logger */
+    GRIFFIN_LOG_INLINE file_logger::file_logger()
+    {
+        m_file_name = "";
+        m_file_path = "./logs/";
+    }
+
+    GRIFFIN_LOG_INLINE file_logger::file_logger(const std::string& file_name)
+    {
+        set_file_name(file_name);
+    }
+
+    GRIFFIN_LOG_INLINE file_logger::file_logger(const file_logger& other)
+    {
+        copy_from(other);
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::copy_from(const file_logger& other)
+    {
+        set_file_name(other.m_file_name);
+
+        m_durable = other.m_durable;
+        m_sync_lvl = other.m_sync_lvl;
+        m_max_sync_interval = other.m_max_sync_interval;
+    }
+
+    GRIFFIN_LOG_INLINE bool file_logger::is_initialized()
+    {
+        return m_file.is_open();
+    }
+
+    GRIFFIN_LOG_INLINE bool file_logger::init_file_logging(bool include_date_in_name)
+    {
+        if (m_file_name.empty() && m_file_path.empty())
+            set_file_name("grflog_file.log");
+
+	if (include_date_in_name)
+	{
+	    std::string date = sys_methods::get_date_time().substr(0, 10);
+	    set_file_name(date + m_file_name);
+	}
+
+        if (!is_initialized())
+        {
+            sys_methods::make_directory("./logs");
+            m_file.open(m_file_path, std::ios::out);
+        }
+        else
+        {
+            finish_file_logging();
+            m_file.open(m_file_path);
+        }
+
+        if (is_initialized() && m_durable)
+        {
+            // Durable lines can't be promised without a handle to sync, or if the file's entry may vanish on a crash
+            m_sync_handle = sys_methods::open_sync_handle(m_file_path);
+            if (m_sync_handle == GRIFFIN_INVALID_FILE_HANDLE || !sys_methods::sync_directory("./logs"))
+            {
+                sys_methods::close_sync_handle(m_sync_handle);
+                m_sync_handle = GRIFFIN_INVALID_FILE_HANDLE;
+                m_file.close();
+                return false;
+            }
+
+            m_sync_failed = false;
+            m_stop_syncer = false;
+            m_syncer = std::make_unique<std::thread>(&file_logger::run_syncer, this);
+        }
+
+        return is_initialized();
+    }
+
+    GRIFFIN_LOG_INLINE uint64_t file_logger::append(const std::string& what)
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        m_file << what;
+        return ++m_write_seq;
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::write_to_file(const std::string& what)
+    {
+        append(what);
+    }
+
+    GRIFFIN_LOG_INLINE bool file_logger::write_to_file(const std::string& what, const log_level& lvl)
+    {
+        const uint64_t seq = append(what);
+        if (m_sync_handle == GRIFFIN_INVALID_FILE_HANDLE || lvl < m_sync_lvl)
+            return true;
+
+        // A forked child inherits the handle but not the syncer thread, see after_fork_child()
+        if (!m_syncer)
+            return flush_and_sync();
+
+        std::unique_lock<std::mutex> lock(m_sync_mutex);
+        m_sync_requested = true;
+        m_syncer_cv.notify_one();
+        m_waiters_cv.wait(lock, [&]() { return m_synced_seq >= seq || m_sync_failed; });
+        return m_synced_seq >= seq;
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::set_durability(const log_level& sync_lvl, std::chrono::milliseconds max_sync_interval)
+    {
+        m_durable = true;
+        m_sync_lvl = sync_lvl;
+        m_max_sync_interval = max_sync_interval;
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::run_syncer()
+    {
+        std::unique_lock<std::mutex> lock(m_sync_mutex);
+        uint64_t synced = m_synced_seq;
+
+        while (!m_stop_syncer)
+        {
+            m_syncer_cv.wait_for(lock, m_max_sync_interval, [this]() { return m_sync_requested || m_stop_syncer; });
+            m_sync_requested = false;
+            lock.unlock();
+
+            // Everything written so far goes in this sync, including lines of waiters that arrive meanwhile
+            uint64_t target;
+            bool ok = true;
+            {
+                std::lock_guard<std::mutex> write_lock(m_write_mutex);
+                target = m_write_seq;
+                if (target != synced)
+                    ok = m_file.flush().good();
+            }
+
+            if (target != synced)
+                ok = ok && sys_methods::sync_file_data(m_sync_handle);
+
+            synced = target;
+            lock.lock();
+
+            // A failed sync may have dropped the dirty pages, so nothing written from then on counts as durable
+            if (!ok)
+                m_sync_failed = true;
+            else if (!m_sync_failed)
+                m_synced_seq = synced;
+            m_waiters_cv.notify_all();
+        }
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::stop_syncer()
+    {
+        if (m_sync_handle == GRIFFIN_INVALID_FILE_HANDLE)
+            return;
+
+        // A forked child has no syncer, nor anyone waiting on it
+        const bool had_syncer = m_syncer != nullptr;
+        if (had_syncer)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sync_mutex);
+                m_stop_syncer = true;
+            }
+            m_syncer_cv.notify_one();
+            m_syncer->join();
+            m_syncer.reset();
+        }
+
+        uint64_t target;
+        {
+            std::lock_guard<std::mutex> write_lock(m_write_mutex);
+            target = m_write_seq;
+        }
+        const bool synced = flush_and_sync();
+        sys_methods::close_sync_handle(m_sync_handle);
+        m_sync_handle = GRIFFIN_INVALID_FILE_HANDLE;
+
+        if (!had_syncer)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_sync_mutex);
+        if (synced)
+            m_synced_seq = target;
+        m_waiters_cv.notify_all();
+    }
+
+    GRIFFIN_LOG_INLINE bool file_logger::flush_and_sync()
+    {
+        bool flushed;
+        {
+            std::lock_guard<std::mutex> write_lock(m_write_mutex);
+            flushed = m_file.flush().good();
+        }
+
+        if (!flushed || !sys_methods::sync_file_data(m_sync_handle))
+            m_sync_failed = true;
+
+        return !m_sync_failed;
+    }
+
+    GRIFFIN_LOG_INLINE bool file_logger::sync_failed() const
+    {
+        return m_sync_failed.load();
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::before_fork()
+    {
+        m_write_mutex.lock();
+        m_sync_mutex.lock();
+
+        if (m_file.is_open())
+            m_file.flush();
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::after_fork_parent()
+    {
+        m_sync_mutex.unlock();
+        m_write_mutex.unlock();
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::after_fork_child()
+    {
+        m_sync_mutex.unlock();
+        m_write_mutex.unlock();
+
+        // The syncer thread only runs in the parent, this copy of it can't be joined
+        (void)m_syncer.release();
+        m_sync_requested = false;
+        m_stop_syncer = false;
+    }
+
+    GRIFFIN_LOG_INLINE const std::string file_logger::get_file_name()
+    {
+        return m_file_name;
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::set_file_name(const std::string& file_name)
+    {
+        m_file_name = file_name;
+        m_file_path = "./logs/" + m_file_name;
+    }
+
+    GRIFFIN_LOG_INLINE void file_logger::finish_file_logging()
+    {
+        stop_syncer();
+
+        if (is_initialized())
+        {
+            m_file.flush();
+            m_file.close();
+        }
+    }
+
+    GRIFFIN_LOG_INLINE file_logger::~file_logger()
+    {
+        finish_file_logging();
+    }
+
+
+    /// Get the file used for logging.
+    /// @returns A file_logger reference to keep track of file to log.
+    GRIFFIN_LOG_INLINE file_logger& get_file_logger()
+    {
+        static file_logger f;
+
+        #if defined(GRIFFIN_LOG_LINUX)
+
+        static const bool fork_handlers = pthread_atfork(
+            []() { get_file_logger().before_fork(); },
+            []() { get_file_logger().after_fork_parent(); },
+            []() { get_file_logger().after_fork_child(); }) == 0;
+        (void)fork_handlers;
+
+        #endif // GRIFFIN_LOG_LINUX
+
+        return f;
+    }
+
+    GRIFFIN_LOG_INLINE void set_file_logger(const file_logger& file, bool include_date_in_name)
+    {
+        file_logger& fl = get_file_logger();
+
+        fl.copy_from(file);
+        if (!fl.init_file_logging(include_date_in_name))
+            critical("Couldn't add file");
+    }
+
+    GRIFFIN_LOG_INLINE void stop_file_logging()
+    {
+        get_file_logger().finish_file_logging();
+    }
+
+    GRIFFIN_LOG_INLINE bool file_sync_failed()
+    {
+        return get_file_logger().sync_failed();
+    }
+
+    GRIFFIN_LOG_INLINE void file_log(const log_event& l_ev)
+    {
+        file_logger& fl = get_file_logger();
+        if (fl.is_initialized())
+            fl.write_to_file("[" + l_ev.date_time + "] [" + l_ev.log_lvl_str + "] " + visual::get_sample_rate_str(l_ev.sample_rate) + l_ev.content + "\n", l_ev.lvl);
+    }
+
+    GRIFFIN_LOG_INLINE void dispatch_log(const log_event& l_ev)
+    {
+        #if defined(GRIFFIN_LOG_LINUX)
+
+        if (shm::forward(l_ev))
+            return;
+
+        #endif // GRIFFIN_LOG_LINUX
+
+        console_log(l_ev);
+        file_log(l_ev);
+    }
+
+}
+
+#include "shm_ring.hpp"
@@ -24,12 +24,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <cstdint>
 #include <utility>
 #include <string_view>
 #include <string>
 #include <format>
+#include <type_traits>
 
 /* GRIFFIN LOG PLATFORM DEFINITIONS */
 #if defined(WIN32) || defined(_WIN32)
@@ -59,6 +68,9 @@
     #define GRIFFIN_COLOR_YELLOW    0x0e
     #define GRIFFIN_COLOR_BLACK_RED 0xc0
 
+    typedef HANDLE GRIFFIN_FILE_HANDLE;
+    #define GRIFFIN_INVALID_FILE_HANDLE INVALID_HANDLE_VALUE
+
 #elif defined(GRIFFIN_LOG_LINUX)
     typedef std::string GRIFFIN_COLOR;
 
@@ -69,9 +81,27 @@
     #define GRIFFIN_COLOR_BLACK_RED "\x1b[38;2;0;0;0;48;2;255;0;0;1;1m"
     #define GRIFFIN_COLOR_RESET     "\x1b[0m"
 
+    typedef int GRIFFIN_FILE_HANDLE;
+    #define GRIFFIN_INVALID_FILE_HANDLE (-1)
+
 #endif // GRIFFIN_LOG_WIN32
 
 #define GRIFFIN_LOG(lvl, what, args)  log(lvl, what, std::forward<Args>((args))...)
+#define GRIFFIN_LOG_KEYED(key, lvl, what, args)  log(key, lvl, what, std::forward<Args>((args))...)
+
+/* GRIFFIN LOG BUILD MODE */
+// Define GRIFFIN_LOG_HEADER_ONLY to use Griffin Log without the static library: every function is
+// then defined inline in the headers, so log calls can be inlined and their level checks folded.
+#if defined(GRIFFIN_LOG_HEADER_ONLY)
+    #define GRIFFIN_LOG_INLINE inline
+#else
+    #define GRIFFIN_LOG_INLINE
+#endif // GRIFFIN_LOG_HEADER_ONLY
+
+// Lowest log level compiled in (0 = INFO ... 4 = FATAL). Calls below it compile to nothing.
+#if !defined(GRIFFIN_LOG_ACTIVE_LEVEL)
+    #define GRIFFIN_LOG_ACTIVE_LEVEL 0
+#endif // GRIFFIN_LOG_ACTIVE_LEVEL
 
 namespace grflog
 {
@@ -81,6 +111,24 @@ namespace grflog
         /// @param dirPath Path to create the new  directory.
         void make_directory(const std::string& dirPath);
 
+        /// Open a file for syncing its data to stable storage. Platform specific.
+        /// @param path Path of the file.
+        /// @returns The file handle, or GRIFFIN_INVALID_FILE_HANDLE if it couldn't be opened.
+        GRIFFIN_FILE_HANDLE open_sync_handle(const std::string& path);
+
+        /// Flush the file's data to stable storage (fdatasync on Linux, FlushFileBuffers on Win32).
+        /// @param handle Handle returned by open_sync_handle().
+        /// @returns false if the data couldn't be synced.
+        bool sync_file_data(GRIFFIN_FILE_HANDLE handle);
+
+        /// Sync a directory's entries, so a file created in it survives a crash (fsync on Linux, no-op on Win32).
+        /// @param dir_path Path of the directory.
+        /// @returns false if the directory couldn't be opened or synced.
+        bool sync_directory(const std::string& dir_path);
+
+        /// Close a handle returned by open_sync_handle().
+        void close_sync_handle(GRIFFIN_FILE_HANDLE handle);
+
         /// Get the current local date time.
         const std::string get_date_time();
 
@@ -106,6 +154,113 @@ namespace grflog
         FATAL       =       4
     };
 
+    /// Lowest log level written at runtime, see set_log_level().
+    inline std::atomic<log_level> g_min_log_level{ log_level::INFO };
+
+    /// Set the lowest log level to be logged, events below it are discarded before formatting.
+    /// @param lvl Lowest log level to log.
+    inline void set_log_level(const log_level& lvl)
+    {
+        g_min_log_level.store(lvl, std::memory_order_relaxed);
+    }
+
+    /// Check if events of a log level are logged, against GRIFFIN_LOG_ACTIVE_LEVEL and set_log_level().
+    /// @param lvl log level to check.
+    inline bool should_log(const log_level& lvl)
+    {
+        return lvl >= static_cast<log_level>(GRIFFIN_LOG_ACTIVE_LEVEL)
+            && lvl >= g_min_log_level.load(std::memory_order_relaxed);
+    }
+
+    namespace sampling
+    {
+        /// Keep threshold meaning every event is kept. Thresholds are out of 2^32.
+        inline constexpr uint64_t KEEP_ALL = uint64_t(1) << 32;
+
+        /// Per log level keep thresholds, see set_sample_rate().
+        inline std::atomic<uint64_t> g_keep_thresholds[5] = { KEEP_ALL, KEEP_ALL, KEEP_ALL, KEEP_ALL, KEEP_ALL };
+
+        /// Set the fraction of events of a log level to keep, e.g. 0.01 keeps 1% of them.
+        /// The decision is taken in log() before formatting, so dropped events cost only the decision.
+        /// @param lvl log level to sample.
+        /// @param rate Fraction to keep, from 0.0 (drop all) to 1.0 (keep all, the default).
+        inline void set_sample_rate(const log_level& lvl, double rate)
+        {
+            uint64_t threshold = KEEP_ALL;
+            if (rate <= 0.0)
+                threshold = 0;
+            else if (rate < 1.0)
+                threshold = static_cast<uint64_t>(rate * static_cast<double>(KEEP_ALL));
+
+            g_keep_thresholds[static_cast<uint8_t>(lvl)].store(threshold, std::memory_order_relaxed);
+        }
+
+        /// Get the fraction of events of a log level being kept.
+        /// @param lvl log level to check.
+        inline double get_sample_rate(const log_level& lvl)
+        {
+            return static_cast<double>(g_keep_thresholds[static_cast<uint8_t>(lvl)].load(std::memory_order_relaxed))
+                / static_cast<double>(KEEP_ALL);
+        }
+
+        /// splitmix64 finalizer, spreads any 64 bit value over the whole range.
+        inline uint64_t mix(uint64_t x)
+        {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+
+        /// Fast thread local PRNG (splitmix64), seeded per thread.
+        inline uint64_t next_random()
+        {
+            thread_local uint64_t state = mix(reinterpret_cast<uintptr_t>(&state)
+                ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+            state += 0x9e3779b97f4a7c15ull;
+            return mix(state);
+        }
+
+        /// Caller supplied key (request id, trace id...) for consistent sampling: every event logged
+        /// with the same key gets the same keep or drop decision, in every thread and process.
+        struct sample_key
+        {
+            /// @param id Numeric id to sample on.
+            explicit sample_key(uint64_t id)
+                : hash(mix(id))
+                {}
+
+            /// @param id String id to sample on, hashed with FNV-1a.
+            explicit sample_key(std::string_view id)
+                : hash(0)
+            {
+                uint64_t h = 0xcbf29ce484222325ull;
+                for (char c : id)
+                    h = (h ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+                hash = mix(h);
+            }
+
+            uint64_t hash;
+        };
+
+        /// Random keep or drop decision for an event of a log level.
+        /// @param lvl log level of the event.
+        inline bool keep(const log_level& lvl)
+        {
+            const uint64_t threshold = g_keep_thresholds[static_cast<uint8_t>(lvl)].load(std::memory_order_relaxed);
+            return threshold == KEEP_ALL || (next_random() >> 32) < threshold;
+        }
+
+        /// Consistent keep or drop decision for an event of a log level, taken from the key's hash.
+        /// @param lvl log level of the event.
+        /// @param key Sampling key of the event.
+        inline bool keep(const log_level& lvl, const sample_key& key)
+        {
+            const uint64_t threshold = g_keep_thresholds[static_cast<uint8_t>(lvl)].load(std::memory_order_relaxed);
+            return threshold == KEEP_ALL || (key.hash >> 32) < threshold;
+        }
+    }
+
     namespace visual
     {
         /// Function to get the correspondent string for the log level.
@@ -124,6 +279,12 @@ namespace grflog
         
         /// Function to reset the console's text's color. Platform specific.
         void reset_text_color();
+
+
+        /// Function to get the sample rate tag written before sampled events' content.
+        /// @param rate Sample rate of the event.
+        /// @returns "[sample rate R] ", or an empty string if every event of its level is kept.
+        const std::string get_sample_rate_str(double rate);
     }
 
     struct log_event
@@ -135,16 +296,163 @@ namespace grflog
 
         const std::string content;
 
+        const double sample_rate;
+
         /// Log event constructor, get every needed information for a log event.
         /// @param dt Date Time string formatted as: YYYY-mm-dd H:M:S (see sys_methods::get_date_time()).
         /// @param llvl Log Level of this log event.
         /// @param fmt_what "Formatted What" formatted message to log in this event.
-        log_event(const log_level& llvl, const std::string& msg)
+        /// @param rate Sample rate the event was kept with (see sampling::set_sample_rate()).
+        log_event(const log_level& llvl, const std::string& msg, double rate=1.0)
             : date_time((sys_methods::get_date_time())), 
               lvl(llvl), 
               log_lvl_str(visual::get_log_lvl_str(llvl)), 
-              content(msg) 
+              content(msg),
+              sample_rate(rate)
               {} 
+
+        /// Log event constructor for events that already carry their date time, e.g. the ones
+        /// drained from the shared memory ring (see shm_ring.hpp).
+        /// @param dt Date Time string formatted as: YYYY-mm-dd H:M:S.
+        /// @param llvl Log Level of this log event.
+        /// @param msg Already formatted message of this event.
+        /// @param rate Sample rate the event was kept with.
+        log_event(const std::string& dt, const log_level& llvl, const std::string& msg, double rate=1.0)
+            : date_time(dt),
+              lvl(llvl),
+              log_lvl_str(visual::get_log_lvl_str(llvl)),
+              content(msg),
+              sample_rate(rate)
+              {}
+    };
+
+    namespace sanitize
+    {
+        /// Find the first control character (below 0x20 except tab, or DEL) or backslash with SSE2 or AVX2
+        /// depending on the target, falling back to find_control_scalar() for the tail.
+        /// @param data Bytes to scan.
+        /// @param size Number of bytes.
+        /// @returns Index of the first control character, or size if there is none.
+        std::size_t find_control(const char* data, std::size_t size);
+
+        /// Scalar reference of find_control().
+        std::size_t find_control_scalar(const char* data, std::size_t size);
+
+        /// Escape every control character and backslash of content from index 'from' on: \n, \r, \\, or \xHH.
+        /// Escaping the backslash keeps a literal "\n" in the message apart from an escaped newline.
+        /// @param content String to escape in place.
+        /// @param from Index of the first control character, as returned by find_control().
+        void escape_controls(std::string& content, std::size_t from=0);
+
+        /// Escape content only if it has control characters, so clean content costs one vectorized scan.
+        /// @param content String to sanitize in place.
+        inline void sanitize_content(std::string& content)
+        {
+            const std::size_t first = find_control(content.data(), content.size());
+            if (first != content.size())
+                escape_controls(content, first);
+        }
+    }
+
+    /// Whether log() sanitizes formatted content, see set_sanitize_content().
+    inline std::atomic<bool> g_sanitize_content_enabled{ false };
+
+    /// Set if log() should escape control characters (newlines, ANSI escapes...) in formatted messages,
+    /// so user controlled strings can't forge log lines or mess with the terminal. Off by default.
+    /// @param sanitize_content set on or off
+    inline void set_sanitize_content(bool sanitize_content)
+    {
+        g_sanitize_content_enabled.store(sanitize_content, std::memory_order_relaxed);
+    }
+
+    // Logging context (MDC)
+
+    /// Thread's logging context: the fields of every live context_guard, rendered once when each guard
+    /// is entered. 'rendered' is put as is in front of every message logged from this thread, so truncating
+    /// a long message (e.g. into a shared memory ring slot) never cuts the context.
+    struct log_context
+    {
+        std::string fields;     // "req=42 tenant=acme"
+        std::string rendered;   // "{req=42 tenant=acme} ", empty if there are no fields
+
+        /// Rebuild 'rendered' from 'fields'.
+        void render()
+        {
+            rendered.clear();
+            if (!fields.empty())
+                rendered.append("{").append(fields).append("} ");
+        }
+    };
+
+    /// Logging context of the calling thread.
+    inline thread_local log_context t_log_context;
+
+    /// A key=value field of a context_guard, its value is formatted once on construction.
+    struct context_field
+    {
+        /// @param k Field name.
+        /// @param v Field value, strings are taken as is and anything else is formatted with "{}".
+        /// Values that are empty or hold spaces, '=', braces, quotes, backslashes or control characters
+        /// are rendered quoted and escaped, so they can't forge other fields.
+        template<typename T>
+        context_field(std::string_view k, const T& v)
+            : key(k)
+        {
+            if constexpr (std::is_convertible_v<const T&, std::string_view>)
+                value = std::string(std::string_view(v));
+            else
+                value = sys_methods::fmt_str("{}", v);
+        }
+
+        std::string_view key;
+        std::string value;
+    };
+
+    /// Pushes fields onto this thread's logging context for its scope, every event logged meanwhile
+    /// carries them. Guards must be destroyed in reverse order of construction on the thread that built
+    /// them; to carry a context across threads or coroutine suspensions use capture_context() and context_restore.
+    /// @code grflog::context_guard g{{"req", id}, {"tenant", t}};
+    class context_guard
+    {
+    public:
+        /// Render the fields and append them to the thread's context.
+        /// @param fields Fields to add.
+        context_guard(std::initializer_list<context_field> fields);
+
+        context_guard(const context_guard&) = delete;
+        context_guard& operator=(const context_guard&) = delete;
+
+        /// Remove this guard's fields from the thread's context.
+        ~context_guard();
+
+    private:
+        std::size_t m_previous_size;
+    };
+
+    /// Copy of a thread's logging context, see capture_context().
+    struct context_snapshot
+    {
+        std::string fields;
+    };
+
+    /// Capture the calling thread's logging context, to restore it in another thread or after a coroutine resumes.
+    context_snapshot capture_context();
+
+    /// Replaces the calling thread's logging context with a captured one for its scope.
+    class context_restore
+    {
+    public:
+        /// @param snapshot Context returned by capture_context().
+        context_restore(const context_snapshot& snapshot);
+
+        context_restore(const context_restore&) = delete;
+        context_restore& operator=(const context_restore&) = delete;
+
+        /// Put back the context the thread had before.
+        ~context_restore();
+
+    private:
+        std::string m_previous_fields;
     };
 
     // Logging functions
@@ -198,6 +506,21 @@ namespace grflog
         /// @param what string message to be written.
         void write_to_file(const std::string& what);
 
+        /// Write a log line to the file. If durability is set and lvl is at or above its sync level,
+        /// only returns once the line is on stable storage.
+        /// @param what string message to be written.
+        /// @param lvl log level of the message.
+        /// @returns false if the line had to be synced and wasn't, see sync_failed().
+        bool write_to_file(const std::string& what, const log_level& lvl);
+
+        /// Make file logging durable, taking effect on init_file_logging(). Events at or above sync_lvl
+        /// wait for a background syncer to put them on stable storage, and every waiter that arrives
+        /// while a sync is running shares the next one (group commit). Everything else is synced at most
+        /// max_sync_interval after being written. A forked child has no syncer, so it syncs its own lines.
+        /// @param sync_lvl Lowest log level that waits for its line to be synced.
+        /// @param max_sync_interval Longest time a written line stays unsynced.
+        void set_durability(const log_level& sync_lvl, std::chrono::milliseconds max_sync_interval=std::chrono::milliseconds(1000));
+
         /// Get the file's name.
         const std::string get_file_name();
 
@@ -205,15 +528,62 @@ namespace grflog
         /// @param file_name File name to set
         void set_file_name(const std::string& file_name);
 
-        /// Finish the file logging, close and flush the std::ofstream file.
+        /// Finish the file logging, close and flush the std::ofstream file (and sync it, if durable).
         void finish_file_logging();
 
+        /// Check if a flush or sync of a durable file failed. Lines written since may not be on stable
+        /// storage even if a later sync succeeds, so the error sticks until init_file_logging().
+        bool sync_failed() const;
+
+        /// Flush and lock the file before fork(), so the child neither writes the parent's buffered lines
+        /// again nor inherits a mutex locked by another thread. Installed with pthread_atfork() for the
+        /// file used by log().
+        void before_fork();
+
+        /// Unlock the file in the parent after fork().
+        void after_fork_parent();
+
+        /// Unlock the file in the child after fork() and forget the parent's syncer thread,
+        /// the child syncs its own lines at the sync level.
+        void after_fork_child();
+
         ~file_logger();
 
     private:
+        /// Write to the file.
+        /// @returns The write's sequence number, to wait for its sync.
+        uint64_t append(const std::string& what);
+
+        /// Background syncer loop, flushes and syncs on request or every m_max_sync_interval.
+        void run_syncer();
+
+        /// Stop the syncer, then flush and sync whatever it didn't.
+        void stop_syncer();
+
+        /// Flush the stream and sync it, called with m_write_mutex unlocked.
+        /// @returns false if either failed, m_sync_failed is then set.
+        bool flush_and_sync();
+
         std::string m_file_name;
         std::string m_file_path;
         std::ofstream m_file;
+
+        bool m_durable = false;
+        log_level m_sync_lvl = log_level::CRITICAL;
+        std::chrono::milliseconds m_max_sync_interval{ 1000 };
+        GRIFFIN_FILE_HANDLE m_sync_handle = GRIFFIN_INVALID_FILE_HANDLE;
+
+        std::mutex m_write_mutex;
+        uint64_t m_write_seq = 0;
+
+        std::mutex m_sync_mutex;
+        std::condition_variable m_syncer_cv;
+        std::condition_variable m_waiters_cv;
+        uint64_t m_synced_seq = 0;
+        bool m_sync_requested = false;
+        bool m_stop_syncer = false;
+        std::atomic<bool> m_sync_failed{ false };
+        std::unique_ptr<std::thread> m_syncer;
     };
 
 
@@ -225,69 +595,172 @@ namespace grflog
     /// Stop current file from logging if there is one.
     void stop_file_logging();
 
+    /// Check if the durable file failed to flush or sync, so some lines may not be on stable storage.
+    bool file_sync_failed();
+
     /// File logging function, will be called from log().
     /// @param l_ev Log event struct to be used for logging the information into a file.
     void file_log(const log_event& l_ev);
 
+    /// Send the log event to the sinks, will be called from log().
+    /// Calls console_log() and file_log(), unless this process is attached as a producer of a shared
+    /// memory ring (see shm_ring.hpp), in which case the event is pushed to the ring for the collector.
+    /// @param l_ev Log event struct to be dispatched.
+    void dispatch_log(const log_event& l_ev);
+
+    /// Finish a formatted message and dispatch it, called by log() once the event passed filtering and sampling.
+    /// Sanitizes the message if enabled, prepends the thread's logging context (see context_guard) and builds its log_event.
+    /// The context is escaped once when rendered, so it isn't sanitized again.
+    /// @param lvl The log level of the event.
+    /// @param formatted The formatted message.
+    inline void emit_log(const log_level& lvl, std::string formatted)
+    {
+        if (g_sanitize_content_enabled.load(std::memory_order_relaxed))
+            sanitize::sanitize_content(formatted);
+
+        const std::string& context = t_log_context.rendered;
+        if (!context.empty())
+            formatted.insert(0, context);
+
+        log_event l_ev(lvl, formatted, sampling::get_sample_rate(lvl));
+
+        dispatch_log(l_ev);
+    }
+
     /// Main logging function, will create a log_event struct object with the needed information and 
-    /// call console_log() and file_log() (if file was added) passing the created log_event.
+    /// pass it to dispatch_log(), which calls console_log() and file_log() (if file was added).
+    /// Events dropped by should_log() or sampling cost only those checks, nothing is allocated or formatted.
     /// @param lvl The log level to use. Enumerated in enum log_level.
     /// @param what The message to be logged.
     /// @param args Values to format in message 'what'
     template<typename ... Args>
-    void log(const log_level& lvl, const std::string& what, Args&&... args)
+    void log(const log_level& lvl, std::string_view what, Args&&... args)
     {
-	std::string formatted = sys_methods::fmt_str(what, std::forward<Args>(args)...);
+        if (!should_log(lvl) || !sampling::keep(lvl))
+            return;
+
+	emit_log(lvl, sys_methods::fmt_str(what, std::forward<Args>(args)...));
+    }
 
-        log_event l_ev(lvl, formatted);
+    /// Consistently sampled logging function, same as log() but the sampling decision is taken from key,
+    /// so every event logged with the same key is either kept or dropped together.
+    /// @param key Sampling key, e.g. the request or trace id.
+    /// @param lvl The log level to use. Enumerated in enum log_level.
+    /// @param what The message to be logged.
+    /// @param args Values to format in message 'what'
+    template<typename ... Args>
+    void log(const sampling::sample_key& key, const log_level& lvl, std::string_view what, Args&&... args)
+    {
+        if (!should_log(lvl) || !sampling::keep(lvl, key))
+            return;
 
-        console_log(l_ev);
-        file_log(l_ev);
+        emit_log(lvl, sys_methods::fmt_str(what, std::forward<Args>(args)...));
     }
     // Level implemented logging functions
     
     /// Info logging function, simply calls log() with log_level::INFO
     /// @param what The INFO message to be logged.
     template<typename ... Args>
-    void info(const std::string& what, Args&& ... args)
+    void info(std::string_view what, Args&& ... args)
     {
         GRIFFIN_LOG(log_level::INFO, what, args);
     }
+
+    /// Info logging function sampled on key, simply calls log() with the key and log_level::INFO
+    /// @param key Sampling key of the event.
+    /// @param what The INFO message to be logged.
+    template<typename ... Args>
+    void info(const sampling::sample_key& key, std::string_view what, Args&& ... args)
+    {
+        GRIFFIN_LOG_KEYED(key, log_level::INFO, what, args);
+    }
    
 
     /// Debug logging function, simply calls log() with log_level::DEBUG
     /// @param what The DEBUG message to be logged.
     template<typename ... Args>
-    void debug(const std::string& what, Args&& ... args)
+    void debug(std::string_view what, Args&& ... args)
     {
         GRIFFIN_LOG(log_level::DEBUG, what, args);
     }
 
+    /// Debug logging function sampled on key, simply calls log() with the key and log_level::DEBUG
+    /// @param key Sampling key of the event.
+    /// @param what The DEBUG message to be logged.
+    template<typename ... Args>
+    void debug(const sampling::sample_key& key, std::string_view what, Args&& ... args)
+    {
+        GRIFFIN_LOG_KEYED(key, log_level::DEBUG, what, args);
+    }
+
 
 
     /// Warn logging function, simply calls log() with log_level::WARN
     /// @param what The WARN message to be logged.
     template<typename ... Args>
-    void warn(const std::string& what, Args&& ... args)
+    void warn(std::string_view what, Args&& ... args)
     {
         GRIFFIN_LOG(log_level::WARN, what, args);
+    }
+
+    /// Warn logging function sampled on key, simply calls log() with the key and log_level::WARN
+    /// @param key Sampling key of the event.
+    /// @param what The WARN message to be logged.
+    template<typename ... Args>
+    void warn(const sampling::sample_key& key, std::string_view what, Args&& ... args)
+    {
+        GRIFFIN_LOG_KEYED(key, log_level::WARN, what, args);
     }   
 
 
     /// Critical logging function, simply calls log() with log_level::CRITICAL
     /// @param what The CRITICAL message to be logged.
     template<typename ... Args>
-    void critical(const std::string& what, Args&& ... args)
+    void critical(std::string_view what, Args&& ... args)
     {
         GRIFFIN_LOG(log_level::CRITICAL, what, args);
     }
 
+    /// Critical logging function sampled on key, simply calls log() with the key and log_level::CRITICAL
+    /// @param key Sampling key of the event.
+    /// @param what The CRITICAL message to be logged.
+    template<typename ... Args>
+    void critical(const sampling::sample_key& key, std::string_view what, Args&& ... args)
+    {
+        GRIFFIN_LOG_KEYED(key, log_level::CRITICAL, what, args);
+    }
+
 
     /// Fatal logging function, simply calls log() with log_level::FATAL
     /// @param what The FATAL message to be logged.
     template<typename ... Args>
-    void fatal(const std::string& what, Args&& ... args)
+    void fatal(std::string_view what, Args&& ... args)
     {
         GRIFFIN_LOG(log_level::FATAL, what, args);
     }
+
+    /// Fatal logging function sampled on key, simply calls log() with the key and log_level::FATAL
+    /// @param key Sampling key of the event.
+    /// @param what The FATAL message to be logged.
+    template<typename ... Args>
+    void fatal(const sampling::sample_key& key, std::string_view what, Args&& ... args)
+    {
+        GRIFFIN_LOG_KEYED(key, log_level::FATAL, what, args);
+    }
+}
+
+#if defined(GRIFFIN_LOG_HEADER_ONLY)
+    #include "griffinLog-inl.hpp"
+#else
+namespace grflog
+{
+    // Message only calls are the most common ones, instantiate them once in the static library
+    extern template std::string sys_methods::fmt_str<>(std::string_view fmt);
+    extern template void log<>(const log_level& lvl, std::string_view what);
+    extern template void info<>(std::string_view what);
+    extern template void debug<>(std::string_view what);
+    extern template void warn<>(std::string_view what);
+    extern template void critical<>(std::string_view what);
+    extern template void fatal<>(std::string_view what);
 }
+#endif // GRIFFIN_LOG_HEADER_ONLY
@@ -0,0 +1,199 @@
+/* 
+* MIT License
+* 
+* Copyright (c) 2021 juliokscesar
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#if !defined(GRIFFIN_LOG_HEADER_ONLY)
+    #include "scoped_timer.hpp"
+#endif // GRIFFIN_LOG_HEADER_ONLY
+
+#include <map>
+#include <memory>
+
+namespace grflog
+{
+    namespace timing
+    {
+        GRIFFIN_LOG_INLINE double ticks_per_ns()
+        {
+            #if defined(GRIFFIN_LOG_USE_TSC)
+
+            static const double ratio = []()
+            {
+                const auto wall_start = std::chrono::steady_clock::now();
+                const uint64_t tsc_start = __rdtsc();
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                const uint64_t tsc_end = __rdtsc();
+                const auto wall_end = std::chrono::steady_clock::now();
+
+                const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count();
+                return static_cast<double>(tsc_end - tsc_start) / static_cast<double>(ns);
+            }();
+            return ratio;
+
+            #else
+
+            return 1.0;
+
+            #endif // GRIFFIN_LOG_USE_TSC
+        }
+    }
+
+    /* class latency_histogram */
+    GRIFFIN_LOG_INLINE uint64_t latency_histogram::count() const
+    {
+        uint64_t total = 0;
+        for (const auto& bucket : m_buckets)
+            total += bucket.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    GRIFFIN_LOG_INLINE uint64_t latency_histogram::percentile(double p) const
+    {
+        const uint64_t total = count();
+        if (total == 0)
+            return 0;
+
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total));
+        if (rank >= total)
+            rank = total - 1;
+
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen > rank)
+                return bucket_lower_bound(i);
+        }
+
+        return max_value();
+    }
+
+    GRIFFIN_LOG_INLINE uint64_t latency_histogram::max_value() const
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    GRIFFIN_LOG_INLINE void latency_histogram::reset()
+    {
+        for (auto& bucket : m_buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    GRIFFIN_LOG_INLINE uint64_t latency_histogram::bucket_lower_bound(std::size_t index)
+    {
+        if (index < SUB_BUCKETS)
+            return index;
+
+        const std::size_t msb = index / SUB_BUCKETS + 3;
+        const uint64_t sub = index % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub) << (msb - 4);
+    }
+
+    /// Histograms registered by name, they live until the program ends.
+    struct histogram_registry
+    {
+        std::mutex mutex;
+        std::map<std::string, std::unique_ptr<latency_histogram>> histograms;
+    };
+
+    GRIFFIN_LOG_INLINE histogram_registry& get_histogram_registry()
+    {
+        static histogram_registry registry;
+        return registry;
+    }
+
+    GRIFFIN_LOG_INLINE latency_histogram& get_histogram(const std::string& name)
+    {
+        histogram_registry& registry = get_histogram_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        std::unique_ptr<latency_histogram>& h = registry.histograms[name];
+        if (!h)
+            h = std::make_unique<latency_histogram>();
+        return *h;
+    }
+
+    GRIFFIN_LOG_INLINE void dump_histograms(const log_level& lvl)
+    {
+        histogram_registry& registry = get_histogram_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        for (auto& [name, h] : registry.histograms)
+        {
+            const uint64_t n = h->count();
+            if (n == 0)
+                continue;
+
+            log(lvl, "histogram {}: count {} p50 {} us p90 {} us p99 {} us max {} us",
+                name, n,
+                static_cast<double>(h->percentile(50.0)) / 1000.0,
+                static_cast<double>(h->percentile(90.0)) / 1000.0,
+                static_cast<double>(h->percentile(99.0)) / 1000.0,
+                static_cast<double>(h->max_value()) / 1000.0);
+
+            h->reset();
+        }
+    }
+
+    /* class histogram_dumper */
+    GRIFFIN_LOG_INLINE histogram_dumper::histogram_dumper(std::chrono::milliseconds interval, const log_level& lvl)
+        : m_interval(interval), m_lvl(lvl)
+    {
+        m_thread = std::thread([this]()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_cv.wait_for(lock, m_interval, [this]() { return m_stop; }))
+            {
+                lock.unlock();
+                dump_histograms(m_lvl);
+                lock.lock();
+            }
+        });
+    }
+
+    GRIFFIN_LOG_INLINE histogram_dumper::~histogram_dumper()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
+
+        dump_histograms(m_lvl);
+    }
+
+    /* class scoped_timer */
+    GRIFFIN_LOG_INLINE void scoped_timer::report(uint64_t elapsed_ticks) const
+    {
+        const double elapsed_us = static_cast<double>(timing::ticks_to_ns(elapsed_ticks)) / 1000.0;
+
+        if (m_parent_id != 0)
+            log(m_lvl, "span {} took {} us (id {:x}, parent {:x})", m_name, elapsed_us, m_id, m_parent_id);
+        else
+            log(m_lvl, "span {} took {} us (id {:x})", m_name, elapsed_us, m_id);
+    }
+}
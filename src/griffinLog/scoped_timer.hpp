@@ -0,0 +1,294 @@
+/* 
+* MIT License
+* 
+* Copyright (c) 2021 juliokscesar
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include "griffinLog.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if defined(GRIFFIN_LOG_TIMER_TSC) && (defined(__x86_64__) || defined(_M_X64))
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif // _MSC_VER
+    #define GRIFFIN_LOG_USE_TSC
+#endif // GRIFFIN_LOG_TIMER_TSC && x86_64
+
+/*
+* Scoped timers (spans) built on the logger.
+*
+* A scoped_timer reads the clock when constructed and when destroyed, and only logs the elapsed time if it
+* crossed its threshold, so fast scopes cost two clock reads and a compare. Timers nest: each one gets an
+* id and records the id of the enclosing timer of the same thread as its parent. A timer can also feed a
+* latency_histogram instead of (or besides) logging, and the histograms are logged with dump_histograms().
+*
+* Define GRIFFIN_LOG_TIMER_TSC to read the x86-64 TSC instead of std::chrono::steady_clock. It is calibrated
+* against steady_clock once, so it assumes an invariant TSC.
+*/
+
+namespace grflog
+{
+    namespace timing
+    {
+        /// Read the timer clock, in ticks (see ticks_per_ns()).
+        inline uint64_t now_ticks()
+        {
+            #if defined(GRIFFIN_LOG_USE_TSC)
+
+            return __rdtsc();
+
+            #else
+
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+
+            #endif // GRIFFIN_LOG_USE_TSC
+        }
+
+        /// Timer clock ticks per nanosecond, measured once when using the TSC.
+        double ticks_per_ns();
+
+        /// Convert timer clock ticks to nanoseconds.
+        /// @param ticks Tick count to convert.
+        inline uint64_t ticks_to_ns(uint64_t ticks)
+        {
+            #if defined(GRIFFIN_LOG_USE_TSC)
+
+            return static_cast<uint64_t>(static_cast<double>(ticks) / ticks_per_ns());
+
+            #else
+
+            return ticks;
+
+            #endif // GRIFFIN_LOG_USE_TSC
+        }
+
+        /// Convert nanoseconds to timer clock ticks.
+        /// @param ns Nanoseconds to convert.
+        inline uint64_t ns_to_ticks(uint64_t ns)
+        {
+            #if defined(GRIFFIN_LOG_USE_TSC)
+
+            return static_cast<uint64_t>(static_cast<double>(ns) * ticks_per_ns());
+
+            #else
+
+            return ns;
+
+            #endif // GRIFFIN_LOG_USE_TSC
+        }
+
+        /// Id of the innermost scoped_timer alive in this thread, 0 if there is none.
+        inline thread_local uint64_t t_current_span_id = 0;
+
+        /// Spans ids are this thread's index in the high bits and a thread local counter in the low bits.
+        inline std::atomic<uint64_t> g_span_thread_count{ 0 };
+        inline thread_local uint64_t t_span_id_prefix = 0;
+        inline thread_local uint64_t t_span_id_counter = 0;
+
+        /// Get a new span id, unique across threads.
+        inline uint64_t next_span_id()
+        {
+            if (t_span_id_prefix == 0)
+                t_span_id_prefix = (g_span_thread_count.fetch_add(1, std::memory_order_relaxed) + 1) << 40;
+
+            return t_span_id_prefix | ++t_span_id_counter;
+        }
+    }
+
+    /// Latency histogram with HDR-style log-linear buckets: 16 linear sub-buckets per power of two,
+    /// so any recorded value is known within 1/16 (about 6%). Recording is a single relaxed atomic add.
+    class latency_histogram
+    {
+    public:
+        static constexpr std::size_t SUB_BUCKETS = 16;
+        static constexpr std::size_t BUCKET_COUNT = (64 - 3) * SUB_BUCKETS;
+
+        latency_histogram() = default;
+        latency_histogram(const latency_histogram&) = delete;
+        latency_histogram& operator=(const latency_histogram&) = delete;
+
+        /// Record a value.
+        /// @param ns Latency in nanoseconds.
+        void record(uint64_t ns)
+        {
+            m_buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+
+            uint64_t max = m_max.load(std::memory_order_relaxed);
+            while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+                ;
+        }
+
+        /// Number of values recorded since the last reset.
+        uint64_t count() const;
+
+        /// Value at a percentile, as the lower bound of its bucket.
+        /// @param p Percentile from 0.0 to 100.0.
+        uint64_t percentile(double p) const;
+
+        /// Largest value recorded since the last reset.
+        uint64_t max_value() const;
+
+        /// Clear every bucket.
+        void reset();
+
+        /// Bucket holding a value.
+        /// @param ns Value to find the bucket for.
+        static std::size_t bucket_index(uint64_t ns)
+        {
+            if (ns < SUB_BUCKETS)
+                return static_cast<std::size_t>(ns);
+
+            const unsigned msb = 63 - static_cast<unsigned>(std::countl_zero(ns));
+            const uint64_t sub = (ns >> (msb - 4)) & (SUB_BUCKETS - 1);
+            return (msb - 3) * SUB_BUCKETS + static_cast<std::size_t>(sub);
+        }
+
+        /// Lowest value of a bucket.
+        /// @param index Bucket index.
+        static uint64_t bucket_lower_bound(std::size_t index);
+
+    private:
+        std::atomic<uint64_t> m_buckets[BUCKET_COUNT] = {};
+        std::atomic<uint64_t> m_max{ 0 };
+    };
+
+    /// Get the histogram registered with a name, creating it if needed.
+    /// Look it up once and keep the reference, the lookup takes a lock.
+    /// @param name Name of the histogram.
+    latency_histogram& get_histogram(const std::string& name);
+
+    /// Log count, p50, p90, p99 and max of every histogram that recorded something, then reset them.
+    /// @param lvl log level to log the histograms with.
+    void dump_histograms(const log_level& lvl=log_level::INFO);
+
+    /// Calls dump_histograms() periodically from a background thread while alive.
+    class histogram_dumper
+    {
+    public:
+        /// Start dumping.
+        /// @param interval Time between dumps.
+        /// @param lvl log level to log the histograms with.
+        histogram_dumper(std::chrono::milliseconds interval, const log_level& lvl=log_level::INFO);
+
+        histogram_dumper(const histogram_dumper&) = delete;
+        histogram_dumper& operator=(const histogram_dumper&) = delete;
+
+        /// Stop the thread, dumping one last time.
+        ~histogram_dumper();
+
+    private:
+        std::chrono::milliseconds m_interval;
+        log_level m_lvl;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_stop = false;
+        std::thread m_thread;
+    };
+
+    /// Scoped timer, logs how long its scope took if it crossed a threshold.
+    class scoped_timer
+    {
+    public:
+        /// Start the timer.
+        /// @param name Name of the timed scope, must outlive the timer (usually a string literal).
+        /// @param threshold Elapsed time from which the timer logs, zero logs every time.
+        /// @param lvl log level to log with.
+        /// @param histogram Histogram to record every elapsed time into, or nullptr.
+        scoped_timer(const char* name,
+                     std::chrono::nanoseconds threshold=std::chrono::nanoseconds::zero(),
+                     const log_level& lvl=log_level::INFO,
+                     latency_histogram* histogram=nullptr)
+            : m_name(name),
+              m_threshold_ticks(threshold == (std::chrono::nanoseconds::max)()
+                  ? (std::numeric_limits<uint64_t>::max)()
+                  : timing::ns_to_ticks(static_cast<uint64_t>(threshold.count()))),
+              m_histogram(histogram),
+              m_id(timing::next_span_id()),
+              m_parent_id(timing::t_current_span_id),
+              m_lvl(lvl)
+        {
+            timing::t_current_span_id = m_id;
+            m_start = timing::now_ticks();
+        }
+
+        /// Histogram only timer, never logs.
+        /// @param name Name of the timed scope.
+        /// @param histogram Histogram to record every elapsed time into.
+        scoped_timer(const char* name, latency_histogram& histogram)
+            : scoped_timer(name, (std::chrono::nanoseconds::max)(), log_level::INFO, &histogram)
+            {}
+
+        scoped_timer(const scoped_timer&) = delete;
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+        /// Id of this timer.
+        uint64_t id() const { return m_id; }
+
+        /// Id of the enclosing timer of this thread, 0 if there is none.
+        uint64_t parent_id() const { return m_parent_id; }
+
+        /// Stop the timer, record it and log it if it crossed the threshold.
+        ~scoped_timer()
+        {
+            const uint64_t elapsed = timing::now_ticks() - m_start;
+            timing::t_current_span_id = m_parent_id;
+
+            if (m_histogram)
+                m_histogram->record(timing::ticks_to_ns(elapsed));
+
+            if (elapsed >= m_threshold_ticks) [[unlikely]]
+                report(elapsed);
+        }
+
+    private:
+        void report(uint64_t elapsed_ticks) const;
+
+        const char* m_name;
+        uint64_t m_threshold_ticks;
+        latency_histogram* m_histogram;
+        uint64_t m_id;
+        uint64_t m_parent_id;
+        uint64_t m_start;
+        log_level m_lvl;
+    };
+
+    /// Spans are scoped timers, the name reads better when tracing nested scopes.
+    using span = scoped_timer;
+}
+
+#if defined(GRIFFIN_LOG_HEADER_ONLY)
+    #include "scoped_timer-inl.hpp"
+#endif // GRIFFIN_LOG_HEADER_ONLY
@@ -0,0 +1,618 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 juliokscesar
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#if !defined(GRIFFIN_LOG_HEADER_ONLY)
+    #include "shm_ring.hpp"
+#endif // GRIFFIN_LOG_HEADER_ONLY
+
+#if defined(GRIFFIN_LOG_LINUX)
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace grflog
+{
+    namespace shm
+    {
+        inline constexpr uint64_t RING_MAGIC = 0x47524646524e4731ull; // "GRFFRNG1"
+        inline constexpr uint32_t RING_VERSION = 4;
+
+        /// Time to wait on a pending slot before checking if its owner is still alive.
+        inline constexpr auto STALE_CHECK_DELAY = std::chrono::milliseconds(50);
+
+        GRIFFIN_LOG_INLINE std::string shm_name(const std::string& name)
+        {
+            return (!name.empty() && name[0] == '/') ? name : "/" + name;
+        }
+
+        GRIFFIN_LOG_INLINE uint32_t round_up_pow2(uint32_t n)
+        {
+            uint32_t p = 1;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+
+        /// Check if a process is alive. A crashed process stays a zombie until its parent reaps it,
+        /// and kill() still succeeds on zombies, so their state is read from /proc.
+        /// @param pid Process to check.
+        GRIFFIN_LOG_INLINE bool process_alive(int32_t pid)
+        {
+            if (pid <= 0)
+                return false;
+
+            if (kill(pid, 0) == -1 && errno == ESRCH)
+                return false;
+
+            char path[32];
+            snprintf(path, sizeof(path), "/proc/%d/stat", static_cast<int>(pid));
+
+            // Without /proc mounted zombies can't be told apart, so trust kill()
+            FILE* f = std::fopen(path, "r");
+            if (!f)
+                return errno != ENOENT || access("/proc/self", F_OK) != 0;
+
+            char buf[512];
+            const std::size_t n = std::fread(buf, 1, sizeof(buf) - 1, f);
+            std::fclose(f);
+            buf[n] = '\0';
+
+            // Format is "pid (comm) state ...", comm may itself contain parentheses
+            const char* comm_end = std::strrchr(buf, ')');
+            if (!comm_end || comm_end[1] != ' ')
+                return true;
+
+            return comm_end[2] != 'Z' && comm_end[2] != 'X';
+        }
+
+        /// Identify the pid namespace of the calling process, pids are only comparable within one.
+        /// @returns The namespace inode, or 0 if /proc isn't mounted.
+        GRIFFIN_LOG_INLINE uint64_t pid_namespace_id()
+        {
+            struct stat st{};
+            if (stat("/proc/self/ns/pid", &st) == -1)
+                return 0;
+            return static_cast<uint64_t>(st.st_ino);
+        }
+
+        /// Check if the existing segment at path was left by a collector that is gone.
+        /// @param path Segment name, with its leading '/'.
+        GRIFFIN_LOG_INLINE bool is_stale_segment(const std::string& path)
+        {
+            int fd = shm_open(path.c_str(), O_RDONLY, 0);
+            if (fd == -1)
+                return errno == ENOENT;
+
+            // A live collector may still be sizing and initializing it, give it a moment
+            struct stat st{};
+            for (int i = 0; i < 100; i++)
+            {
+                if (fstat(fd, &st) == -1)
+                {
+                    ::close(fd);
+                    return false;
+                }
+
+                if (static_cast<std::size_t>(st.st_size) >= sizeof(ring_header))
+                    break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            if (static_cast<std::size_t>(st.st_size) < sizeof(ring_header))
+            {
+                ::close(fd);
+                return true;
+            }
+
+            void* mem = mmap(nullptr, sizeof(ring_header), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mem == MAP_FAILED)
+                return false;
+
+            const ring_header* header = static_cast<const ring_header*>(mem);
+            for (int i = 0; i < 100 && header->magic.load(std::memory_order_acquire) != RING_MAGIC; i++)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            const bool stale = header->magic.load(std::memory_order_acquire) != RING_MAGIC
+                || header->version != RING_VERSION
+                || !process_alive(header->creator_pid.load(std::memory_order_relaxed));
+
+            munmap(mem, sizeof(ring_header));
+            return stale;
+        }
+
+        /* class ring */
+        GRIFFIN_LOG_INLINE bool ring::create(const std::string& name, uint32_t slot_count)
+        {
+            close();
+
+            const std::string path = shm_name(name);
+            slot_count = round_up_pow2(slot_count < 2 ? 2 : slot_count);
+
+            const mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP;
+            int fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, mode);
+            if (fd == -1 && errno == EEXIST && is_stale_segment(path))
+            {
+                shm_unlink(path.c_str());
+                fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, mode);
+            }
+
+            if (fd == -1)
+                return false;
+
+            const std::size_t map_size = sizeof(ring_header) + sizeof(ring_slot) * slot_count;
+            if (ftruncate(fd, static_cast<off_t>(map_size)) == -1)
+            {
+                ::close(fd);
+                shm_unlink(path.c_str());
+                return false;
+            }
+
+            void* mem = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mem == MAP_FAILED)
+            {
+                shm_unlink(path.c_str());
+                return false;
+            }
+
+            // The segment is zero filled by ftruncate, construct the atomics in place
+            ring_header* header = new (mem) ring_header;
+            header->version = RING_VERSION;
+            header->slot_count = slot_count;
+            header->creator_pid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+            header->pid_namespace = pid_namespace_id();
+            header->head.store(0, std::memory_order_relaxed);
+            header->tail.store(0, std::memory_order_relaxed);
+            header->dropped.store(0, std::memory_order_relaxed);
+            header->recovered.store(0, std::memory_order_relaxed);
+
+            ring_slot* slots = reinterpret_cast<ring_slot*>(static_cast<char*>(mem) + sizeof(ring_header));
+            for (uint32_t i = 0; i < slot_count; i++)
+            {
+                ring_slot* s = new (&slots[i]) ring_slot;
+                s->seq.store(i, std::memory_order_relaxed);
+                s->owner.store(0, std::memory_order_relaxed);
+            }
+
+            // Attaching processes wait for the magic, so it is the last thing published
+            header->magic.store(RING_MAGIC, std::memory_order_release);
+
+            m_name = path;
+            m_header = header;
+            m_slots = slots;
+            m_map_size = map_size;
+            m_creator_pid = static_cast<int>(getpid());
+            return true;
+        }
+
+        GRIFFIN_LOG_INLINE bool ring::attach(const std::string& name)
+        {
+            close();
+
+            const std::string path = shm_name(name);
+            int fd = shm_open(path.c_str(), O_RDWR, 0);
+            if (fd == -1)
+                return false;
+
+            // The collector may still be sizing the segment, give it a moment
+            struct stat st{};
+            for (int i = 0; i < 100; i++)
+            {
+                if (fstat(fd, &st) == -1)
+                {
+                    ::close(fd);
+                    return false;
+                }
+
+                if (static_cast<std::size_t>(st.st_size) >= sizeof(ring_header))
+                    break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            if (static_cast<std::size_t>(st.st_size) < sizeof(ring_header))
+            {
+                ::close(fd);
+                return false;
+            }
+
+            const std::size_t map_size = static_cast<std::size_t>(st.st_size);
+            void* mem = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mem == MAP_FAILED)
+                return false;
+
+            ring_header* header = static_cast<ring_header*>(mem);
+            for (int i = 0; i < 100 && header->magic.load(std::memory_order_acquire) != RING_MAGIC; i++)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            if (header->magic.load(std::memory_order_acquire) != RING_MAGIC
+                || header->version != RING_VERSION
+                || map_size < sizeof(ring_header) + sizeof(ring_slot) * header->slot_count
+                || header->pid_namespace != pid_namespace_id())
+            {
+                munmap(mem, map_size);
+                return false;
+            }
+
+            m_name = path;
+            m_header = header;
+            m_slots = reinterpret_cast<ring_slot*>(static_cast<char*>(mem) + sizeof(ring_header));
+            m_map_size = map_size;
+            m_creator_pid = 0;
+            return true;
+        }
+
+        GRIFFIN_LOG_INLINE void ring::close()
+        {
+            if (!is_open())
+                return;
+
+            munmap(m_header, m_map_size);
+            if (m_creator_pid == static_cast<int>(getpid()))
+                shm_unlink(m_name.c_str());
+
+            m_header = nullptr;
+            m_slots = nullptr;
+            m_map_size = 0;
+            m_creator_pid = 0;
+        }
+
+        GRIFFIN_LOG_INLINE bool ring::is_open() const
+        {
+            return m_header != nullptr;
+        }
+
+        GRIFFIN_LOG_INLINE ring_slot& ring::slot_at(uint64_t pos) const
+        {
+            return m_slots[pos & (m_header->slot_count - 1)];
+        }
+
+        GRIFFIN_LOG_INLINE bool ring::push(const log_event& l_ev)
+        {
+            const int32_t pid = static_cast<int32_t>(getpid());
+            uint64_t pos = m_header->head.load(std::memory_order_relaxed);
+            ring_slot* s;
+
+            for (;;)
+            {
+                s = &slot_at(pos);
+                const uint64_t seq = s->seq.load(std::memory_order_acquire);
+                const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+                if (diff < 0)
+                {
+                    // Collector is a full lap behind
+                    m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                if (diff > 0)
+                {
+                    pos = m_header->head.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                // The claim and its owner's pid are one CAS, so the collector never sees a claimed slot without a pid
+                uint64_t owner = 0;
+                if (s->owner.compare_exchange_strong(owner, slot_owner(pos, pid), std::memory_order_acq_rel))
+                {
+                    // Seen free before the claim, but the slot may have moved on to a later lap meanwhile
+                    if (s->seq.load(std::memory_order_acquire) == pos)
+                    {
+                        uint64_t expected = pos;
+                        m_header->head.compare_exchange_strong(expected, pos + 1, std::memory_order_relaxed);
+                        break;
+                    }
+
+                    s->owner.store(0, std::memory_order_release);
+                }
+                else if (owner == slot_owner(pos, static_cast<int32_t>(owner)))
+                {
+                    // Claimed by another producer that didn't move head past it yet, help it
+                    uint64_t expected = pos;
+                    m_header->head.compare_exchange_strong(expected, pos + 1, std::memory_order_relaxed);
+                }
+
+                pos = m_header->head.load(std::memory_order_relaxed);
+            }
+
+            const std::size_t len = l_ev.content.size() < SLOT_CONTENT_SIZE ? l_ev.content.size() : SLOT_CONTENT_SIZE;
+            std::memcpy(s->content, l_ev.content.data(), len);
+            s->length = static_cast<uint32_t>(len);
+            s->lvl = l_ev.lvl;
+            s->sample_rate = l_ev.sample_rate;
+
+            const std::size_t dt_len = l_ev.date_time.size() < sizeof(s->date_time) - 1 ? l_ev.date_time.size() : sizeof(s->date_time) - 1;
+            std::memcpy(s->date_time, l_ev.date_time.data(), dt_len);
+            s->date_time[dt_len] = '\0';
+
+            // Fails only if the collector took this process for dead, which the pid namespace check rules out
+            uint64_t expected = pos;
+            if (!s->seq.compare_exchange_strong(expected, pos + 1, std::memory_order_release, std::memory_order_relaxed))
+            {
+                m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            return true;
+        }
+
+        GRIFFIN_LOG_INLINE bool ring::pop(std::string& out_date_time, log_level& out_lvl, std::string& out_content, double& out_sample_rate)
+        {
+            for (;;)
+            {
+                const uint64_t pos = m_header->tail.load(std::memory_order_relaxed);
+                ring_slot& s = slot_at(pos);
+
+                if (s.seq.load(std::memory_order_acquire) != pos + 1)
+                    return false;
+
+                // Read every field once, the segment is writable by any process that can open it
+                const log_level lvl = s.lvl;
+                const uint32_t length = s.length;
+                const std::size_t len = length < SLOT_CONTENT_SIZE ? length : SLOT_CONTENT_SIZE;
+                const bool valid = static_cast<uint8_t>(lvl) <= static_cast<uint8_t>(log_level::FATAL);
+
+                if (valid)
+                {
+                    out_date_time.assign(s.date_time, strnlen(s.date_time, sizeof(s.date_time)));
+                    out_lvl = lvl;
+                    out_sample_rate = s.sample_rate;
+                    out_content.assign(s.content, len);
+                }
+
+                s.owner.store(0, std::memory_order_relaxed);
+                s.seq.store(pos + m_header->slot_count, std::memory_order_release);
+                m_header->tail.store(pos + 1, std::memory_order_release);
+
+                if (valid)
+                    return true;
+                m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        GRIFFIN_LOG_INLINE bool ring::next_pending(uint64_t& out_pos) const
+        {
+            const uint64_t pos = m_header->tail.load(std::memory_order_relaxed);
+            const ring_slot& s = slot_at(pos);
+            if (s.seq.load(std::memory_order_acquire) != pos)
+                return false;
+
+            const uint64_t owner = s.owner.load(std::memory_order_acquire);
+            if (owner == 0 || owner != slot_owner(pos, static_cast<int32_t>(owner)))
+                return false;
+
+            out_pos = pos;
+            return true;
+        }
+
+        GRIFFIN_LOG_INLINE bool ring::recover_stale(uint64_t pos, std::chrono::steady_clock::duration pending_for)
+        {
+            ring_slot& s = slot_at(pos);
+            const uint64_t owner = s.owner.load(std::memory_order_acquire);
+            const int32_t pid = static_cast<int32_t>(owner);
+
+            // A live owner keeps its slot however long it stalls, its writes would land in the next lap otherwise
+            if (owner == 0 || owner != slot_owner(pos, pid) || pending_for < STALE_CHECK_DELAY || process_alive(pid))
+                return false;
+
+            uint64_t expected = pos;
+            if (!s.seq.compare_exchange_strong(expected, pos + m_header->slot_count, std::memory_order_acq_rel))
+                return false;
+
+            s.owner.store(0, std::memory_order_release);
+
+            // The owner may have died before moving head past its slot
+            expected = pos;
+            m_header->head.compare_exchange_strong(expected, pos + 1, std::memory_order_relaxed);
+            m_header->tail.store(pos + 1, std::memory_order_release);
+            m_header->recovered.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        GRIFFIN_LOG_INLINE uint64_t ring::dropped_count() const
+        {
+            return is_open() ? m_header->dropped.load(std::memory_order_relaxed) : 0;
+        }
+
+        GRIFFIN_LOG_INLINE uint64_t ring::recovered_count() const
+        {
+            return is_open() ? m_header->recovered.load(std::memory_order_relaxed) : 0;
+        }
+
+        GRIFFIN_LOG_INLINE ring::~ring()
+        {
+            close();
+        }
+
+        /* class collector */
+        GRIFFIN_LOG_INLINE collector::collector(const std::string& name, uint32_t slot_count)
+            : m_name(name), m_slot_count(slot_count)
+        {
+        }
+
+        GRIFFIN_LOG_INLINE bool collector::open()
+        {
+            if (m_ring.is_open())
+                return true;
+
+            if (!m_ring.create(m_name, m_slot_count))
+                return false;
+
+            m_owner_pid = static_cast<int>(getpid());
+            return true;
+        }
+
+        GRIFFIN_LOG_INLINE bool collector::start()
+        {
+            if (!open() || !is_owner())
+                return false;
+
+            if (m_running.load())
+                return true;
+
+            m_running.store(true);
+            m_thread = std::make_unique<std::thread>(&collector::run, this);
+            return true;
+        }
+
+        GRIFFIN_LOG_INLINE void collector::stop()
+        {
+            if (!is_owner())
+            {
+                // The thread and the consumer side of the ring belong to the parent, this copy of the thread can't be joined
+                m_running.store(false);
+                (void)m_thread.release();
+                return;
+            }
+
+            if (m_running.exchange(false) && m_thread)
+            {
+                m_thread->join();
+                m_thread.reset();
+            }
+
+            if (m_ring.is_open())
+                drain();
+        }
+
+        GRIFFIN_LOG_INLINE bool collector::is_owner() const
+        {
+            return m_owner_pid == static_cast<int>(getpid());
+        }
+
+        GRIFFIN_LOG_INLINE std::size_t collector::drain()
+        {
+            // pop() assumes a single consumer
+            if (!is_owner())
+                return 0;
+
+            std::size_t count = 0;
+            std::string date_time, content;
+            log_level lvl;
+            double sample_rate;
+
+            for (;;)
+            {
+                while (m_ring.pop(date_time, lvl, content, sample_rate))
+                {
+                    log_event l_ev(date_time, lvl, content, sample_rate);
+                    console_log(l_ev);
+                    file_log(l_ev);
+                    count++;
+                }
+
+                uint64_t pos;
+                if (!m_ring.next_pending(pos))
+                {
+                    m_has_pending = false;
+                    break;
+                }
+
+                const auto now = std::chrono::steady_clock::now();
+                if (!m_has_pending || m_pending_pos != pos)
+                {
+                    m_has_pending = true;
+                    m_pending_pos = pos;
+                    m_pending_since = now;
+                }
+
+                // Still being written, come back on the next drain
+                if (!m_ring.recover_stale(pos, now - m_pending_since))
+                    break;
+
+                m_has_pending = false;
+            }
+
+            return count;
+        }
+
+        GRIFFIN_LOG_INLINE const ring& collector::get_ring() const
+        {
+            return m_ring;
+        }
+
+        GRIFFIN_LOG_INLINE void collector::run()
+        {
+            auto idle = std::chrono::microseconds(50);
+            while (m_running.load(std::memory_order_relaxed))
+            {
+                if (drain() > 0)
+                {
+                    idle = std::chrono::microseconds(50);
+                    continue;
+                }
+
+                std::this_thread::sleep_for(idle);
+                if (idle < std::chrono::milliseconds(5))
+                    idle *= 2;
+            }
+        }
+
+        GRIFFIN_LOG_INLINE collector::~collector()
+        {
+            stop();
+            m_ring.close();
+        }
+
+        /// Get the ring this process produces into.
+        GRIFFIN_LOG_INLINE ring& get_producer_ring()
+        {
+            static ring r;
+            return r;
+        }
+
+        GRIFFIN_LOG_INLINE bool attach_producer(const std::string& name)
+        {
+            return get_producer_ring().attach(name);
+        }
+
+        GRIFFIN_LOG_INLINE void detach_producer()
+        {
+            get_producer_ring().close();
+        }
+
+        GRIFFIN_LOG_INLINE bool forward(const log_event& l_ev)
+        {
+            ring& r = get_producer_ring();
+            if (!r.is_open())
+                return false;
+
+            r.push(l_ev);
+            return true;
+        }
+    }
+}
+
+#endif // GRIFFIN_LOG_LINUX
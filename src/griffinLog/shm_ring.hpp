@@ -0,0 +1,246 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 juliokscesar
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include "griffinLog.hpp"
+
+#if defined(GRIFFIN_LOG_LINUX)
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+/*
+* Shared memory transport for multi-process logging (Linux only).
+*
+* One process owns a collector, which creates a named POSIX shared memory segment holding a
+* bounded multi-producer ring of fixed size slots. Every process that wants its logs in the
+* common stream (forked children, unrelated processes, and usually the owner itself) calls
+* attach_producer() with the same name: from then on log() pushes its events into the ring
+* instead of writing them, and the collector is the only one writing to the console and file.
+*
+* Producers never block: when the ring is full the event is dropped and counted. A producer claims
+* a slot and records its pid with a single CAS, so the collector can tell when the producer died
+* between claiming and publishing the slot, and skips it once the pid is gone or a zombie.
+* Pids are only checked within one pid namespace, producers from another one can't attach.
+*
+* Forked children inherit the collector object but not its thread. The inherited copy never joins
+* that thread nor consumes the ring, so children can leave normally.
+*/
+
+namespace grflog
+{
+    namespace shm
+    {
+        /// Maximum bytes of message content stored per slot, longer messages are truncated.
+        inline constexpr std::size_t SLOT_CONTENT_SIZE = 464;
+
+        /// Default number of slots of a ring. Always rounded up to a power of two.
+        inline constexpr uint32_t DEFAULT_SLOT_COUNT = 4096;
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm ring needs lock free 64 bit atomics");
+        static_assert(std::atomic<int32_t>::is_always_lock_free, "shm ring needs lock free 32 bit atomics");
+
+        /// Owner word of a slot claimed for ticket pos by process pid, 0 means unclaimed.
+        /// @param pos Ticket of the slot, only its low 32 bits are kept.
+        /// @param pid Pid of the claiming producer.
+        constexpr uint64_t slot_owner(uint64_t pos, int32_t pid)
+        {
+            return (pos << 32) | static_cast<uint32_t>(pid);
+        }
+
+        /// Slot of the ring, lives in shared memory.
+        /// seq == pos means free for the producer of ticket pos, seq == pos + 1 means published.
+        /// A producer owns the slot of ticket pos once it swapped owner from 0 to slot_owner(pos, pid).
+        struct ring_slot
+        {
+            std::atomic<uint64_t> seq;
+            std::atomic<uint64_t> owner;
+            uint32_t length;
+            float sample_rate;
+            log_level lvl;
+            char date_time[20];
+            char content[SLOT_CONTENT_SIZE];
+        };
+
+        /// Header at the beginning of the shared memory segment.
+        struct ring_header
+        {
+            std::atomic<uint64_t> magic;
+            uint32_t version;
+            uint32_t slot_count;
+            std::atomic<int32_t> creator_pid;
+            uint64_t pid_namespace;
+
+            alignas(64) std::atomic<uint64_t> head;
+            alignas(64) std::atomic<uint64_t> tail;
+
+            alignas(64) std::atomic<uint64_t> dropped;
+            std::atomic<uint64_t> recovered;
+        };
+
+        /// A mapped shared memory ring, either created (collector side) or attached (producer side).
+        class ring
+        {
+        public:
+            ring() = default;
+            ring(const ring&) = delete;
+            ring& operator=(const ring&) = delete;
+
+            /// Create the named segment. An existing segment is only replaced if its collector is dead,
+            /// otherwise create() fails so two collectors never share a name.
+            /// @param name Segment name, a leading '/' is added if missing.
+            /// @param slot_count Number of slots, rounded up to a power of two.
+            /// @returns true if the segment was created and mapped.
+            bool create(const std::string& name, uint32_t slot_count=DEFAULT_SLOT_COUNT);
+
+            /// Attach to a segment created by a collector.
+            /// @param name Segment name used on create().
+            /// @returns true if the segment exists, was mapped and its collector shares our pid namespace.
+            bool attach(const std::string& name);
+
+            /// Unmap the segment, and unlink its name if this ring was created by the calling process.
+            void close();
+
+            /// Check if the ring is mapped.
+            bool is_open() const;
+
+            /// Push an event into the ring, never blocks.
+            /// @param l_ev Log event to copy into a slot.
+            /// @returns false if the ring was full or the slot was reclaimed, the event is then dropped.
+            bool push(const log_event& l_ev);
+
+            /// Pop the next published event, consumer side only. Any process may write the segment, so
+            /// slots with an invalid level are skipped and counted as dropped, and lengths are clamped.
+            /// @param out_date_time, out_lvl, out_content, out_sample_rate Filled with the event fields on success.
+            /// @returns true if an event was popped.
+            bool pop(std::string& out_date_time, log_level& out_lvl, std::string& out_content, double& out_sample_rate);
+
+            /// Check if the next slot was claimed by a producer but not published yet.
+            /// @param out_pos Ticket of the pending slot.
+            bool next_pending(uint64_t& out_pos) const;
+
+            /// Skip the pending slot at ticket pos if its owner died, consumer side only.
+            /// @param pos Ticket returned by next_pending().
+            /// @param pending_for How long the consumer has been waiting on this slot.
+            /// @returns true if the slot was skipped.
+            bool recover_stale(uint64_t pos, std::chrono::steady_clock::duration pending_for);
+
+            /// Events dropped by producers because the ring was full, or by pop() because their slot was invalid.
+            uint64_t dropped_count() const;
+
+            /// Slots skipped because their producer crashed mid-write.
+            uint64_t recovered_count() const;
+
+            ~ring();
+
+        private:
+            ring_slot& slot_at(uint64_t pos) const;
+
+            std::string m_name;
+            ring_header* m_header = nullptr;
+            ring_slot* m_slots = nullptr;
+            std::size_t m_map_size = 0;
+            int m_creator_pid = 0;
+        };
+
+        /// Drains a ring into console_log() and file_log(), either from a background thread or by hand.
+        class collector
+        {
+        public:
+            /// Construct the collector, the segment is only created on open() or start().
+            /// @param name Segment name producers will attach to.
+            /// @param slot_count Number of slots of the ring.
+            collector(const std::string& name, uint32_t slot_count=DEFAULT_SLOT_COUNT);
+
+            collector(const collector&) = delete;
+            collector& operator=(const collector&) = delete;
+
+            /// Create the shared memory segment, the calling process becomes its only consumer.
+            /// @returns true if the segment was created.
+            bool open();
+
+            /// Open the segment if needed and start the background thread draining it.
+            /// @returns false if the segment couldn't be created.
+            bool start();
+
+            /// Stop the background thread and drain everything left in the ring.
+            /// In a forked child it only forgets the parent's thread, the ring stays with the parent.
+            void stop();
+
+            /// Write every published event into the sinks, skipping slots of crashed producers.
+            /// Does nothing outside the process that opened the ring.
+            /// @returns Number of events written.
+            std::size_t drain();
+
+            /// Get the underlying ring, e.g. to read the drop counters.
+            const ring& get_ring() const;
+
+            /// Stop the thread, unmap and unlink the segment.
+            ~collector();
+
+        private:
+            void run();
+
+            /// Check if the calling process opened the ring.
+            bool is_owner() const;
+
+            std::string m_name;
+            uint32_t m_slot_count;
+            ring m_ring;
+            std::unique_ptr<std::thread> m_thread;
+            std::atomic<bool> m_running{false};
+            int m_owner_pid = 0;
+
+            bool m_has_pending = false;
+            uint64_t m_pending_pos = 0;
+            std::chrono::steady_clock::time_point m_pending_since;
+        };
+
+        /// Attach this process as a producer: log() will push its events into the named ring.
+        /// Forked children inherit the attachment, since the mapping is shared.
+        /// @param name Segment name of a running collector.
+        /// @returns true if attached, otherwise logging keeps going to the console and file.
+        bool attach_producer(const std::string& name);
+
+        /// Detach this process from the ring, log() writes to the console and file again.
+        void detach_producer();
+
+        /// Push the event into the ring if this process is attached as a producer, called by dispatch_log().
+        /// @param l_ev Log event to forward.
+        /// @returns true if the event was handled by the ring (pushed or dropped), false if not attached.
+        bool forward(const log_event& l_ev);
+    }
+}
+
+#endif // GRIFFIN_LOG_LINUX
+
+#if defined(GRIFFIN_LOG_HEADER_ONLY)
+    #include "shm_ring-inl.hpp"
+#endif // GRIFFIN_LOG_HEADER_ONLY
@@ -22,8 +22,24 @@
 * SOFTWARE.
 */
 
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
 #include "griffinLog/griffinLog.hpp"
+#include "griffinLog/shm_ring.hpp"
+#include "griffinLog/scoped_timer.hpp"
+
+#if defined(GRIFFIN_LOG_LINUX)
+    #include <cerrno>
+    #include <csignal>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif // GRIFFIN_LOG_LINUX
 
 int main()
 {
@@ -53,5 +69,399 @@ int main()
     std::string s = "this is a c++ string";
     grflog::info("std::string logging: {}", s);
 
+    std::cout << "Durable File Test\n";
+    {
+        grflog::file_logger durable("durable_test.log");
+        durable.set_durability(grflog::log_level::CRITICAL, std::chrono::milliseconds(50));
+        grflog::set_file_logger(durable, false);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+        {
+            threads.emplace_back([t]()
+            {
+                for (int i = 0; i < 25; i++)
+                {
+                    grflog::info("Durable thread {} info {}", t, i);
+                    grflog::critical("Durable thread {} critical {}", t, i);
+                }
+            });
+        }
+
+        for (std::thread& t : threads)
+            t.join();
+
+#if defined(GRIFFIN_LOG_LINUX)
+        // Not synced yet, so still buffered when forking
+        for (int i = 0; i < 5; i++)
+            grflog::info("Durable buffered line {}", i);
+
+        // A forked child has no syncer thread, its critical lines must still return once synced,
+        // without writing the parent's buffered lines a second time
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            grflog::critical("Durable forked child critical");
+            _exit(grflog::file_sync_failed() ? 1 : 0);
+        }
+
+        int child_status = -1;
+        for (int waited = 0; waitpid(child, &child_status, WNOHANG) == 0; waited++)
+        {
+            if (waited == 500)
+            {
+                kill(child, SIGKILL);
+                waitpid(child, &child_status, 0);
+                std::cout << "Forked child blocked on a durable write\n";
+                return 1;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        if (!WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0)
+        {
+            std::cout << "Forked child couldn't sync its durable write\n";
+            return 1;
+        }
+
+        const int expected_lines = 206;
+#else
+        const int expected_lines = 200;
+#endif // GRIFFIN_LOG_LINUX
+
+        auto count_lines = []()
+        {
+            std::ifstream in("./logs/durable_test.log");
+            int lines = 0;
+            for (std::string line; std::getline(in, line); )
+                lines++;
+            return lines;
+        };
+
+        // Every critical line returned after being synced, so it must be in the file before stopping
+        const int synced_lines = count_lines();
+        grflog::stop_file_logging();
+        const int lines = count_lines();
+
+        if (synced_lines < expected_lines || lines != expected_lines || grflog::file_sync_failed())
+        {
+            std::cout << "Durable file has " << lines << " lines (" << synced_lines << " before stopping), expected "
+                      << expected_lines << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Sampling Test\n";
+    {
+        grflog::sampling::set_sample_rate(grflog::log_level::DEBUG, 0.1);
+
+        int kept = 0;
+        for (uint64_t id = 0; id < 100000; id++)
+        {
+            const grflog::sampling::sample_key key(id);
+            const bool first = grflog::sampling::keep(grflog::log_level::DEBUG, key);
+            if (first != grflog::sampling::keep(grflog::log_level::DEBUG, key))
+            {
+                std::cout << "Consistent sampling changed its decision\n";
+                return 1;
+            }
+            kept += first;
+        }
+
+        if (kept < 9000 || kept > 11000)
+        {
+            std::cout << "Consistent sampling kept " << kept << " of 100000 events at rate 0.1\n";
+            return 1;
+        }
+
+        for (int i = 0; i < 50; i++)
+            grflog::debug(grflog::sampling::sample_key("request-42"), "Sampled request line {}", i);
+
+        grflog::sampling::set_sample_rate(grflog::log_level::DEBUG, 1.0);
+    }
+
+    std::cout << "Sanitize Test\n";
+    {
+        // Fuzz the vectorized scan against the scalar reference
+        std::mt19937 rng(2021);
+        for (int round = 0; round < 20000; round++)
+        {
+            std::string buf(rng() % 200, 'a');
+            for (char& c : buf)
+            {
+                c = static_cast<char>(0x20 + rng() % 0x5f);
+                if (c == '\\')
+                    c = 'a';
+            }
+
+            // Dirty bytes are random, or a backslash half of the time since it is escaped too
+            const int dirty = rng() % 4;
+            for (int d = 0; d < dirty && !buf.empty(); d++)
+                buf[rng() % buf.size()] = (rng() % 2) ? '\\' : static_cast<char>(rng() % 256);
+
+            const std::size_t offset = buf.empty() ? 0 : rng() % (buf.size() + 1);
+            const char* data = buf.data() + offset;
+            const std::size_t size = buf.size() - offset;
+
+            if (grflog::sanitize::find_control(data, size) != grflog::sanitize::find_control_scalar(data, size))
+            {
+                std::cout << "Vectorized control scan differs from the scalar one\n";
+                return 1;
+            }
+        }
+
+        std::string forged = "user input\n[2021-01-01 00:00:00] [FATAL] \x1b[31mforged\t\x7f";
+        grflog::sanitize::sanitize_content(forged);
+        if (forged != "user input\\n[2021-01-01 00:00:00] [FATAL] \\x1b[31mforged\t\\x7f")
+        {
+            std::cout << "Sanitized content is wrong: " << forged << '\n';
+            return 1;
+        }
+
+        // A literal backslash-n must not read like an escaped newline
+        forged = "C:\\logs\\new\n";
+        grflog::sanitize::sanitize_content(forged);
+        if (forged != "C:\\\\logs\\\\new\\n")
+        {
+            std::cout << "Sanitized content is wrong: " << forged << '\n';
+            return 1;
+        }
+
+        grflog::set_sanitize_content(true);
+        grflog::warn("Sanitized: {}", "line one\nline two");
+        grflog::set_sanitize_content(false);
+    }
+
+    std::cout << "Logging Context Test\n";
+    {
+        grflog::context_snapshot snapshot;
+        {
+            grflog::context_guard request{{"req", 42}, {"tenant", "acme"}};
+            {
+                grflog::context_guard user{{"user", std::string("julio")}};
+                grflog::info("Inside nested context");
+
+                if (grflog::t_log_context.rendered != "{req=42 tenant=acme user=julio} ")
+                {
+                    std::cout << "Nested context rendered as '" << grflog::t_log_context.rendered << "'\n";
+                    return 1;
+                }
+            }
+
+            if (grflog::t_log_context.fields != "req=42 tenant=acme")
+            {
+                std::cout << "Context wasn't popped on scope exit\n";
+                return 1;
+            }
+
+            snapshot = grflog::capture_context();
+        }
+
+        if (!grflog::t_log_context.rendered.empty())
+        {
+            std::cout << "Context left after every guard was destroyed\n";
+            return 1;
+        }
+
+        bool restored = false;
+        std::thread worker([&]()
+        {
+            grflog::context_restore r(snapshot);
+            grflog::info("Task handed off to another thread");
+            restored = grflog::t_log_context.rendered == "{req=42 tenant=acme} ";
+        });
+        worker.join();
+
+        if (!restored)
+        {
+            std::cout << "Context wasn't restored in the worker thread\n";
+            return 1;
+        }
+
+        // User controlled values can't forge fields, close the context or break the line
+        {
+            grflog::context_guard forged{{"user", "bob tenant=other"}, {"note", "}"}, {"path", "a\"b\\c\nd"}, {"empty", ""}};
+            grflog::info("Inside forged context");
+
+            if (grflog::t_log_context.rendered != "{user=\"bob tenant=other\" note=\"}\" path=\"a\\\"b\\\\c\\nd\" empty=\"\"} ")
+            {
+                std::cout << "Forged context rendered as '" << grflog::t_log_context.rendered << "'\n";
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "Scoped Timer Test\n";
+    {
+        grflog::latency_histogram& h = grflog::get_histogram("test_inner");
+        uint64_t outer_id = 0;
+        {
+            grflog::span outer("test_outer");
+            outer_id = outer.id();
+
+            for (int i = 0; i < 100; i++)
+            {
+                grflog::scoped_timer inner("test_inner", std::chrono::hours(1), grflog::log_level::DEBUG, &h);
+                if (inner.parent_id() != outer_id)
+                {
+                    std::cout << "Nested timer has the wrong parent\n";
+                    return 1;
+                }
+            }
+        }
+
+        if (h.count() != 100 || grflog::timing::t_current_span_id != 0)
+        {
+            std::cout << "Scoped timers didn't record or unwind correctly\n";
+            return 1;
+        }
+
+        grflog::dump_histograms();
+    }
+
+#if defined(GRIFFIN_LOG_LINUX)
+    std::cout << "Shared Memory Ring Test\n";
+    {
+        grflog::shm::collector c("grflog_test_ring");
+        if (!c.start() || !grflog::shm::attach_producer("grflog_test_ring"))
+        {
+            std::cout << "Couldn't open shared memory ring\n";
+            return 1;
+        }
+
+        for (int child = 0; child < 4; child++)
+        {
+            if (fork() == 0)
+            {
+                for (int i = 0; i < 8; i++)
+                    grflog::info("Child {} line {}", child, i);
+
+                // What a worker leaving with exit() runs, it must neither join the parent's thread nor drain
+                c.stop();
+                _exit(c.drain() == 0 ? 0 : 1);
+            }
+        }
+
+        int child_status;
+        bool children_ok = true;
+        while (wait(&child_status) > 0)
+            children_ok = children_ok && WIFEXITED(child_status) && WEXITSTATUS(child_status) == 0;
+
+        if (!children_ok)
+        {
+            std::cout << "A forked child consumed the parent's ring\n";
+            return 1;
+        }
+
+        grflog::info("Parent collected every child");
+        grflog::shm::detach_producer();
+        c.stop();
+
+        if (c.get_ring().dropped_count() != 0)
+        {
+            std::cout << "Shared memory ring dropped events\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Shared Memory Ring Crash Test\n";
+    {
+        grflog::shm::collector c("grflog_crash_ring", 8);
+        grflog::shm::collector other("grflog_crash_ring", 8);
+        if (!c.open() || other.open())
+        {
+            std::cout << "A second collector took over a live ring\n";
+            return 1;
+        }
+
+        const std::size_t size = sizeof(grflog::shm::ring_header) + 8 * sizeof(grflog::shm::ring_slot);
+        int fd = shm_open("/grflog_crash_ring", O_RDWR, 0);
+        void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        auto* header = static_cast<grflog::shm::ring_header*>(mem);
+        auto* slots = reinterpret_cast<grflog::shm::ring_slot*>(static_cast<char*>(mem) + sizeof(grflog::shm::ring_header));
+
+        // The child claims a slot and dies before moving head or publishing it, and stays a zombie until the end
+        const pid_t crashed = fork();
+        if (crashed == 0)
+        {
+            const uint64_t pos = header->head.load();
+            uint64_t unclaimed = 0;
+            slots[pos & 7].owner.compare_exchange_strong(unclaimed, grflog::shm::slot_owner(pos, getpid()));
+            _exit(0);
+        }
+
+        int status;
+        while (waitid(P_PID, crashed, nullptr, WEXITED | WNOWAIT) == -1 && errno == EINTR)
+            ;
+
+        grflog::shm::attach_producer("grflog_crash_ring");
+        for (int i = 0; i < 3; i++)
+            grflog::info("After crashed producer {}", i);
+        grflog::shm::detach_producer();
+
+        // Any process can write the segment, an invalid level is skipped and an oversized length clamped
+        const uint8_t raw_levels[] = { 0xff, static_cast<uint8_t>(grflog::log_level::INFO) };
+        for (const uint8_t lvl : raw_levels)
+        {
+            const uint64_t pos = header->head.fetch_add(1);
+            grflog::shm::ring_slot& s = slots[pos & 7];
+            s.owner.store(grflog::shm::slot_owner(pos, getpid()));
+            s.lvl = static_cast<grflog::log_level>(lvl);
+            s.length = 0xffffffffu;
+            std::memset(s.date_time, 'x', sizeof(s.date_time));
+            std::memset(s.content, 'y', sizeof(s.content));
+            s.seq.store(pos + 1);
+        }
+        munmap(mem, size);
+
+        std::size_t drained = 0;
+        for (int i = 0; i < 200 && drained < 4; i++)
+        {
+            drained += c.drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        waitpid(crashed, &status, 0);
+
+        if (drained != 4 || c.get_ring().recovered_count() != 1 || c.get_ring().dropped_count() != 1)
+        {
+            std::cout << "Crashed producer stalled the ring: drained " << drained
+                      << " recovered " << c.get_ring().recovered_count()
+                      << " dropped " << c.get_ring().dropped_count() << '\n';
+            return 1;
+        }
+    }
+
+    std::cout << "Shared Memory Ring Context Test\n";
+    {
+        grflog::shm::ring r;
+        if (!r.create("grflog_context_ring", 8) || !grflog::shm::attach_producer("grflog_context_ring"))
+        {
+            std::cout << "Couldn't open shared memory ring\n";
+            return 1;
+        }
+
+        // The message is longer than a slot, truncation must keep the context
+        {
+            grflog::context_guard request{{"req", 7}, {"tenant", "acme"}};
+            grflog::info("Long message {}", std::string(2 * grflog::shm::SLOT_CONTENT_SIZE, 'x'));
+        }
+        grflog::shm::detach_producer();
+
+        std::string date_time, content;
+        grflog::log_level lvl;
+        double sample_rate;
+        if (!r.pop(date_time, lvl, content, sample_rate)
+            || content.size() != grflog::shm::SLOT_CONTENT_SIZE
+            || content.rfind("{req=7 tenant=acme} Long message x", 0) != 0)
+        {
+            std::cout << "Context lost in a truncated ring slot: '" << content.substr(0, 40) << "'\n";
+            return 1;
+        }
+    }
+#endif // GRIFFIN_LOG_LINUX
+
     return 0;
 }